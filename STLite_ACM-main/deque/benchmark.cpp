@@ -0,0 +1,114 @@
+#include "deque.hpp"
+#include "class-matrix.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+/**
+ * sweeps the block size: the same mixed workload runs against deques with block_size pinned
+ *   to 64 ... 16384 through the BLOCK_SIZE parameter, and against the adaptive default (last column),
+ *   for int and Diamond::Matrix<double> payloads at several sizes.
+ * the workload is n push_back, then MIDDLE_N random inserts and erases, READ_N random reads
+ *   and one full iteration.
+ * a second table times the same phases apart on the block list and the tiered engine.
+ */
+const int MIDDLE_N = 20000;
+const int READ_N = 200000;
+
+double elapsed(clock_t from) {
+    return double(clock() - from) / CLOCKS_PER_SEC;
+}
+
+int make(int x, int) {
+    return x;
+}
+
+Diamond::Matrix<double> make(int x, const Diamond::Matrix<double> &) {
+    return Diamond::Matrix<double>(2, 2, x);
+}
+
+int weight(int x) {
+    return x;
+}
+
+int weight(const Diamond::Matrix<double> &x) {
+    return int(x[0][0]);
+}
+
+template<class T, size_t B>
+double Bench(int n, long long &checksum) {
+    srand(n);
+    T proto = make(0, T());
+    clock_t from = clock();
+    sjtu::deque<T, sjtu::allocator<T>, B> d;
+    for (int i = 0; i < n; ++i) d.push_back(make(i, proto));
+    for (int i = 0; i < MIDDLE_N; ++i) {
+        d.insert(d.begin() + rand() % (d.size() + 1), make(i, proto));
+        d.erase(d.begin() + rand() % d.size());
+    }
+    for (int i = 0; i < READ_N; ++i) checksum += weight(d[rand() % d.size()]);
+    for (typename sjtu::deque<T, sjtu::allocator<T>, B>::iterator it = d.begin(); it != d.end(); ++it) {
+        checksum += weight(*it);
+    }
+    return elapsed(from);
+}
+
+template<class T>
+void Sweep(const char *name, int n, long long &checksum) {
+    printf("%-7s %9d", name, n);
+    printf(" %7.3f", Bench<T, 64>(n, checksum));
+    printf(" %7.3f", Bench<T, 128>(n, checksum));
+    printf(" %7.3f", Bench<T, 256>(n, checksum));
+    printf(" %7.3f", Bench<T, 512>(n, checksum));
+    printf(" %7.3f", Bench<T, 1024>(n, checksum));
+    printf(" %7.3f", Bench<T, 2048>(n, checksum));
+    printf(" %7.3f", Bench<T, 4096>(n, checksum));
+    printf(" %7.3f", Bench<T, 16384>(n, checksum));
+    printf(" %7.3f\n", Bench<T, 0>(n, checksum));
+    fflush(stdout);
+}
+
+template<class Engine>
+void Phases(int n, long long &checksum) {
+    srand(n);
+    sjtu::deque<int, sjtu::allocator<int>, 0, Engine> d;
+    clock_t from = clock();
+    for (int i = 0; i < n; ++i) d.push_back(i);
+    printf(" %7.3f", elapsed(from));
+    from = clock();
+    for (int i = 0; i < MIDDLE_N; ++i) {
+        d.insert(d.begin() + rand() % (d.size() + 1), i);
+        d.erase(d.begin() + rand() % d.size());
+    }
+    printf(" %7.3f", elapsed(from));
+    from = clock();
+    for (int i = 0; i < READ_N * 10; ++i) checksum += d[rand() % d.size()];
+    printf(" %7.3f", elapsed(from));
+    from = clock();
+    for (typename sjtu::deque<int, sjtu::allocator<int>, 0, Engine>::iterator it = d.begin(); it != d.end(); ++it) {
+        checksum += *it;
+    }
+    printf(" %7.3f", elapsed(from));
+}
+
+int main() {
+    long long checksum = 0;
+    printf("%-7s %9s %7d %7d %7d %7d %7d %7d %7d %7d %7s   (seconds)\n", "payload", "n", 64, 128, 256, 512, 1024,
+           2048, 4096, 16384, "adapt");
+    for (int n = 1000; n <= 10000000; n *= 10) Sweep<int>("int", n, checksum);
+    for (int n = 1000; n <= 100000; n *= 10) Sweep<Diamond::Matrix<double>>("Matrix", n, checksum);
+    printf("\n%-7s %9s %31s   %31s\n", "engine", "", "block_list", "tiered");
+    printf("%-7s %9s", "", "n");
+    for (int i = 0; i < 2; ++i) printf(" %7s %7s %7s %7s", "push", "middle", "read", "iterate");
+    printf("   (seconds)\n");
+    for (int n = 1000; n <= 10000000; n *= 10) {
+        printf("%-7s %9d", "int", n);
+        Phases<sjtu::block_list>(n, checksum);
+        Phases<sjtu::tiered>(n, checksum);
+        printf("\n");
+        fflush(stdout);
+    }
+    printf("checksum %lld\n", checksum);
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "deque.hpp"
+
+#include <deque>
+#include <iostream>
+#include <string>
+
+typedef sjtu::deque<int> Deque;
+typedef std::deque<int> Model;
+
+/**
+ * whether d holds the same elements as m, read both through the iterators and by index.
+ */
+bool same(const Deque &d, const Model &m)
+{
+	if (d.size() != m.size()) return false;
+	Model::const_iterator jt = m.begin();
+	for (Deque::const_iterator it = d.cbegin(); it != d.cend(); ++it, ++jt) {
+		if (*it != *jt) return false;
+	}
+	for (size_t i = 0; i < m.size(); i += 97) {
+		if (d[i] != m[i]) return false;
+	}
+	return true;
+}
+
+void fill(Deque &d, Model &m, int from, int n)
+{
+	for (int i = 0; i < n; ++i) {
+		d.push_back(from + i);
+		m.push_back(from + i);
+	}
+}
+
+void TestSplice()
+{
+	std::cout << "Testing splice at the front, in the middle and at the end..." << std::endl;
+	Deque d;
+	Model m;
+	fill(d, m, 0, 5000);
+	const int where[] = {0, 2500, 5000, 1, 7000};
+	const int length[] = {3000, 1, 700, 4096, 0};
+	for (int k = 0; k < 5; ++k) {
+		Deque other;
+		Model part;
+		fill(other, part, 100000 * (k + 1), length[k]);
+		int pos = where[k] < int(m.size()) ? where[k] : int(m.size());
+		d.splice(d.begin() + pos, other);
+		m.insert(m.begin() + pos, part.begin(), part.end());
+		std::cout << d.size() << " " << other.size() << " " << other.empty() << " " << same(d, m) << std::endl;
+	}
+	Deque empty;
+	Deque full;
+	Model full_model;
+	fill(full, full_model, 7, 300);
+	empty.splice(empty.end(), full);
+	std::cout << same(empty, full_model) << " " << full.size() << std::endl;
+	full.push_back(1);
+	std::cout << full.size() << " " << full.front() << std::endl;
+	int thrown = 0;
+	try {
+		d.splice(empty.begin(), full);
+	} catch (...) {
+		++thrown;
+	}
+	try {
+		d.splice(d.begin(), d);
+	} catch (...) {
+		++thrown;
+	}
+	std::cout << thrown << " " << same(d, m) << std::endl;
+}
+
+/**
+ * 300000 ints run on blocks of thousands of elements, 50 on the smallest blocks.
+ */
+void TestConcat()
+{
+	std::cout << "Testing concat of deques with different block sizes..." << std::endl;
+	Deque big, small;
+	Model big_model, small_model;
+	fill(big, big_model, 0, 300000);
+	fill(small, small_model, -50, 50);
+	Deque copy(big);
+	Model copy_model(big_model);
+	big.concat(small);
+	big_model.insert(big_model.end(), small_model.begin(), small_model.end());
+	std::cout << big.size() << " " << small.size() << " " << same(big, big_model) << std::endl;
+	small_model.clear();
+	fill(small, small_model, -20, 20);
+	small.concat(copy);
+	small_model.insert(small_model.end(), copy_model.begin(), copy_model.end());
+	std::cout << small.size() << " " << copy.size() << " " << same(small, small_model) << std::endl;
+	for (int i = 0; i < 1000; ++i) {
+		small.pop_front();
+		small_model.pop_front();
+		small.insert(small.begin() + small.size() / 2, i);
+		small_model.insert(small_model.begin() + small_model.size() / 2, i);
+	}
+	std::cout << same(small, small_model) << std::endl;
+}
+
+void TestSplitAt()
+{
+	std::cout << "Testing split_at..." << std::endl;
+	Deque d;
+	Model m;
+	fill(d, m, 0, 20000);
+	Deque all = d.split_at(0);
+	std::cout << d.size() << " " << all.size() << " " << same(all, m) << std::endl;
+	Deque none = all.split_at(all.size());
+	std::cout << all.size() << " " << none.size() << " " << same(all, m) << std::endl;
+	Deque tail = all.split_at(12345);
+	Model tail_model(m.begin() + 12345, m.end());
+	m.erase(m.begin() + 12345, m.end());
+	std::cout << all.size() << " " << tail.size() << " " << same(all, m) << " " << same(tail, tail_model) << std::endl;
+	tail.push_front(-1);
+	all.push_back(-2);
+	tail_model.push_front(-1);
+	m.push_back(-2);
+	all.concat(tail);
+	m.insert(m.end(), tail_model.begin(), tail_model.end());
+	std::cout << all.size() << " " << same(all, m) << std::endl;
+	int thrown = 0;
+	try {
+		all.split_at(all.size() + 1);
+	} catch (const sjtu::index_out_of_bound &) {
+		++thrown;
+	}
+	std::cout << thrown << " " << all.size() << std::endl;
+	d.push_back(42);
+	std::cout << d.size() << " " << d.back() << std::endl;
+}
+
+int main()
+{
+	TestSplice();
+	TestConcat();
+	TestSplitAt();
+	return 0;
+}
@@ -0,0 +1,114 @@
+#include "deque.hpp"
+
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <string>
+#include <vector>
+
+typedef sjtu::deque<std::string> Deque;
+
+/**
+ * gathers the positions in index from d and checks them against d[i] one by one.
+ */
+template<class Index>
+void check(const Deque &d, const Index &index)
+{
+	std::vector<std::string> out;
+	d.gather(index.begin(), index.end(), std::back_inserter(out));
+	int bad = 0;
+	size_t k = 0;
+	for (typename Index::const_iterator it = index.begin(); it != index.end(); ++it, ++k) {
+		if (k >= out.size() || out[k] != d[*it]) ++bad;
+	}
+	std::cout << out.size() << " " << bad;
+	if (!out.empty()) std::cout << " " << out.front() << " " << out.back();
+	std::cout << std::endl;
+}
+
+void TestGather()
+{
+	std::cout << "Testing gather..." << std::endl;
+	Deque d;
+	for (int i = 0; i < 50000; ++i) {
+		d.push_back(std::to_string(i));
+		if (i % 3 == 0) d.push_front(std::to_string(-i));
+	}
+	for (int i = 0; i < 1000; ++i) {
+		d.erase(d.begin() + i * 17 % d.size());
+	}
+	std::vector<size_t> sorted;
+	for (size_t i = 0; i < d.size(); i += 37) {
+		sorted.push_back(i);
+	}
+	check(d, sorted);
+	std::vector<size_t> unsorted;
+	for (size_t i = 0; i < 20000; ++i) {
+		unsorted.push_back(i * 7919 % d.size());
+	}
+	check(d, unsorted);
+	std::vector<int> repeated;
+	for (int i = 0; i < 100; ++i) {
+		repeated.push_back(5);
+		repeated.push_back(5);
+		repeated.push_back(int(d.size()) - 1);
+		repeated.push_back(5);
+		repeated.push_back(0);
+	}
+	check(d, repeated);
+	std::vector<size_t> ascending_runs;
+	for (size_t i = 0; i < 3000; ++i) {
+		ascending_runs.push_back(i % 1000 * 50);
+	}
+	check(d, ascending_runs);
+	std::list<size_t> from_list(unsorted.begin(), unsorted.begin() + 500);
+	check(d, from_list);
+	std::vector<size_t> none;
+	check(d, none);
+	std::string buffer[4] = {"a", "b", "c", "d"};
+	size_t two[2] = {3, 1};
+	std::string *end = d.gather(two, two + 2, buffer);
+	std::cout << (end - buffer) << " " << buffer[0] << " " << buffer[1] << " " << buffer[2] << std::endl;
+	end = d.gather(two, two, buffer + 2);
+	std::cout << (end - buffer) << " " << buffer[2] << std::endl;
+}
+
+void TestGatherOutOfRange()
+{
+	std::cout << "Testing gather with a position past the end..." << std::endl;
+	Deque d;
+	for (int i = 0; i < 100; ++i) {
+		d.push_back(std::to_string(i));
+	}
+	std::vector<std::string> out;
+	size_t bad_last[3] = {1, 2, 100};
+	size_t bad_first[3] = {1000, 2, 1};
+	int thrown = 0;
+	try {
+		d.gather(bad_last, bad_last + 3, std::back_inserter(out));
+	} catch (const sjtu::index_out_of_bound &) {
+		++thrown;
+	}
+	try {
+		d.gather(bad_first, bad_first + 3, std::back_inserter(out));
+	} catch (const sjtu::index_out_of_bound &) {
+		++thrown;
+	}
+	std::cout << thrown << " " << out.size() << std::endl;
+	Deque empty;
+	size_t zero[1] = {0};
+	try {
+		empty.gather(zero, zero + 1, std::back_inserter(out));
+	} catch (const sjtu::index_out_of_bound &) {
+		++thrown;
+	}
+	empty.gather(zero, zero, std::back_inserter(out));
+	std::cout << thrown << " " << out.size() << std::endl;
+}
+
+int main()
+{
+	TestGather();
+	TestGatherOutOfRange();
+	return 0;
+}
@@ -0,0 +1,115 @@
+#include "deque.hpp"
+
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * whether d holds the same elements as m, in the same order.
+ */
+template<class Deque, class Model>
+bool same(const Deque &d, const Model &m)
+{
+	if (d.size() != m.size()) return false;
+	typename Model::const_iterator jt = m.begin();
+	for (typename Deque::const_iterator it = d.cbegin(); it != d.cend(); ++it, ++jt) {
+		if (*it != *jt) return false;
+	}
+	return true;
+}
+
+template<class T>
+T make(int i)
+{
+	return T(i);
+}
+
+template<>
+std::string make<std::string>(int i)
+{
+	return std::to_string(i);
+}
+
+template<class T>
+void TestRanges(const char *name)
+{
+	std::cout << "Testing range insert and erase of " << name << "..." << std::endl;
+	typedef sjtu::deque<T> Deque;
+	std::deque<T> m;
+	Deque d;
+	for (int i = 0; i < 1000; ++i) {
+		d.push_back(make<T>(i));
+		m.push_back(make<T>(i));
+	}
+	std::vector<T> none;
+	typename Deque::iterator it = d.insert(d.begin() + 10, none.begin(), none.end());
+	typename Deque::iterator jt = d.insert(d.begin() + 20, 0, make<T>(-1));
+	std::cout << d.size() << " " << (it == d.begin() + 10) << " " << (jt == d.begin() + 20) << std::endl;
+	it = d.erase(d.begin() + 30, d.begin() + 30);
+	std::cout << d.size() << " " << (it == d.begin() + 30) << " " << same(d, m) << std::endl;
+
+	std::vector<T> run;
+	for (int i = 0; i < 5000; ++i) {
+		run.push_back(make<T>(-i));
+	}
+	const int where[] = {0, 500, 6000, 11000};
+	for (int k = 0; k < 4; ++k) {
+		it = d.insert(d.begin() + where[k], run.begin(), run.end());
+		m.insert(m.begin() + where[k], run.begin(), run.end());
+		std::cout << d.size() << " " << (it - d.begin()) << " " << (*it == run.front()) << " " << same(d, m) << std::endl;
+	}
+	it = d.insert(d.begin() + 777, 3000, make<T>(7));
+	m.insert(m.begin() + 777, 3000, make<T>(7));
+	std::cout << d.size() << " " << (it - d.begin()) << " " << (*(it + 2999) == make<T>(7)) << " " << same(d, m) << std::endl;
+	it = d.insert(d.end(), 200, make<T>(8));
+	m.insert(m.end(), 200, make<T>(8));
+	std::cout << d.size() << " " << (it - d.begin()) << " " << same(d, m) << std::endl;
+	it = d.insert(d.begin() + 5, d.begin() + 100, d.begin() + 300);
+	std::deque<T> part(m.begin() + 100, m.begin() + 300);
+	m.insert(m.begin() + 5, part.begin(), part.end());
+	std::cout << d.size() << " " << (it - d.begin()) << " " << same(d, m) << std::endl;
+
+	const int from[] = {3, 64, 1000, 0, 13000};
+	const int count[] = {1, 65, 9000, 50, 2000};
+	for (int k = 0; k < 5; ++k) {
+		it = d.erase(d.begin() + from[k], d.begin() + from[k] + count[k]);
+		typename std::deque<T>::iterator mt = m.erase(m.begin() + from[k], m.begin() + from[k] + count[k]);
+		std::cout << d.size() << " " << (it - d.begin()) << " " << (*it == *mt) << " " << same(d, m) << std::endl;
+	}
+	it = d.erase(d.begin() + d.size() / 2, d.end());
+	m.erase(m.begin() + m.size() / 2, m.end());
+	std::cout << d.size() << " " << (it == d.end()) << " " << same(d, m) << std::endl;
+	d.push_back(make<T>(1));
+	d.push_front(make<T>(2));
+	it = d.erase(d.begin(), d.end());
+	std::cout << d.size() << " " << (it == d.end()) << " " << (it == d.begin()) << " " << d.empty() << std::endl;
+	d.insert(d.begin(), run.begin(), run.end());
+	std::cout << d.size() << " " << (d.front() == run.front()) << " " << (d.back() == run.back()) << std::endl;
+
+	int thrown = 0;
+	Deque other;
+	try {
+		d.erase(d.begin() + 10, d.begin() + 5);
+	} catch (...) {
+		++thrown;
+	}
+	try {
+		d.erase(d.begin(), other.end());
+	} catch (...) {
+		++thrown;
+	}
+	try {
+		d.insert(other.begin(), 3, make<T>(0));
+	} catch (...) {
+		++thrown;
+	}
+	std::cout << thrown << " " << d.size() << std::endl;
+}
+
+int main()
+{
+	TestRanges<int>("int");
+	TestRanges<std::string>("std::string");
+	return 0;
+}
@@ -0,0 +1,92 @@
+#include "work_stealing_deque.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+const int THIEVES = 3;
+const int ROUNDS = 5;
+const int N = 200000;
+
+void TestSequential()
+{
+	std::cout << "Testing work_stealing_deque from one thread..." << std::endl;
+	sjtu::work_stealing_deque<int> q(4);
+	int x = 0;
+	std::cout << q.empty() << " " << q.pop(x) << " " << q.steal(x) << std::endl;
+	for (int i = 1; i <= 10; ++i) {
+		q.push(i);
+	}
+	std::cout << q.size() << std::endl;
+	for (int i = 0; i < 3; ++i) {
+		q.pop(x);
+		std::cout << x << " ";
+	}
+	for (int i = 0; i < 3; ++i) {
+		q.steal(x);
+		std::cout << x << " ";
+	}
+	std::cout << std::endl;
+	while (q.steal(x)) {
+		std::cout << x << " ";
+	}
+	std::cout << std::endl;
+	std::cout << q.empty() << " " << q.pop(x) << std::endl;
+}
+
+/**
+ * the owner pushes 0 .. N - 1 and pops every fourth time while the thieves steal;
+ *   every item must come out exactly once.
+ */
+bool StressRound()
+{
+	sjtu::work_stealing_deque<int> q(2);
+	std::vector<std::vector<int>> taken(THIEVES + 1);
+	std::atomic<bool> done(false);
+	std::vector<std::thread> thieves;
+	for (int k = 1; k <= THIEVES; ++k) {
+		thieves.push_back(std::thread([&q, &taken, &done, k]() {
+			int x = 0;
+			while (!done.load() || !q.empty()) {
+				if (q.steal(x)) taken[k].push_back(x);
+				else std::this_thread::yield();
+			}
+		}));
+	}
+	int x = 0;
+	for (int i = 0; i < N; ++i) {
+		q.push(i);
+		if (i % 4 == 3 && q.pop(x)) taken[0].push_back(x);
+	}
+	while (q.pop(x)) taken[0].push_back(x);
+	done.store(true);
+	for (size_t k = 0; k < thieves.size(); ++k) {
+		thieves[k].join();
+	}
+	std::vector<int> seen(N, 0);
+	for (size_t k = 0; k < taken.size(); ++k) {
+		for (size_t i = 0; i < taken[k].size(); ++i) {
+			++seen[taken[k][i]];
+		}
+	}
+	for (int i = 0; i < N; ++i) {
+		if (seen[i] != 1) return false;
+	}
+	return true;
+}
+
+void TestStress()
+{
+	std::cout << "Testing work_stealing_deque with " << THIEVES << " thieves..." << std::endl;
+	for (int round = 0; round < ROUNDS; ++round) {
+		std::cout << (StressRound() ? "every item taken exactly once" : "items lost or duplicated") << std::endl;
+	}
+}
+
+int main()
+{
+	TestSequential();
+	TestStress();
+	return 0;
+}
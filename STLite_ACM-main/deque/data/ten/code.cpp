@@ -0,0 +1,120 @@
+#include "deque.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+typedef sjtu::deque<int, sjtu::allocator<int>, 64> Deque;
+
+/**
+ * the number of blocks of d, read off display(), which prints a line per block and one for the total.
+ */
+int blocks(Deque &d)
+{
+	std::ostringstream out;
+	std::streambuf *old = std::cout.rdbuf(out.rdbuf());
+	d.display();
+	std::cout.rdbuf(old);
+	std::string text = out.str();
+	int lines = 0;
+	for (size_t i = 0; i < text.size(); ++i) {
+		if (text[i] == '\n') ++lines;
+	}
+	return lines - 1;
+}
+
+/**
+ * whether d holds 0, 64, 128, ... n - 64 and, in between, the first keep values of every run of 64.
+ */
+bool intact(const Deque &d, int keep)
+{
+	size_t k = 0;
+	for (Deque::const_iterator it = d.cbegin(); it != d.cend(); ++it, ++k) {
+		if (*it != int(k / keep * 64 + k % keep)) return false;
+	}
+	return k == d.size();
+}
+
+/**
+ * 6400 elements in 100 full blocks, then 40 erased out of every 64, which leaves every block
+ *   sparse but above a quarter full, so none of them merges.
+ */
+void thin(Deque &d)
+{
+	d.clear();
+	for (int i = 0; i < 6400; ++i) {
+		d.push_back(i);
+	}
+	for (int i = 0; i < 100; ++i) {
+		d.erase(d.begin() + i * 24 + 24, d.begin() + i * 24 + 64);
+	}
+}
+
+void TestCompact()
+{
+	std::cout << "Testing compact..." << std::endl;
+	Deque d;
+	thin(d);
+	std::cout << d.size() << " " << blocks(d) << " " << intact(d, 24) << std::endl;
+	d.compact();
+	std::cout << d.size() << " " << blocks(d) << " " << intact(d, 24) << std::endl;
+	d.compact();
+	std::cout << d.size() << " " << blocks(d) << " " << intact(d, 24) << std::endl;
+	d.insert(d.begin() + 1000, 5);
+	d.erase(d.begin() + 1000);
+	d.push_front(-1);
+	d.pop_front();
+	std::cout << d.size() << " " << intact(d, 24) << std::endl;
+	Deque empty;
+	empty.compact();
+	std::cout << empty.size() << " " << blocks(empty) << std::endl;
+}
+
+void TestAutoCompact()
+{
+	std::cout << "Testing auto_compact..." << std::endl;
+	Deque d;
+	thin(d);
+	d.auto_compact(4);
+	std::cout << blocks(d) << " " << intact(d, 24) << std::endl;
+	d.auto_compact(2);
+	std::cout << blocks(d) << " " << intact(d, 24) << std::endl;
+	thin(d);
+	std::cout << blocks(d) << " " << intact(d, 24) << std::endl;
+	d.auto_compact(0);
+	thin(d);
+	std::cout << blocks(d) << " " << intact(d, 24) << std::endl;
+}
+
+/**
+ * the factor is a setting of the deque: copy construction, copy assignment, moves and swaps carry it.
+ */
+void TestFactorTravels()
+{
+	std::cout << "Testing that copies keep the compaction setting..." << std::endl;
+	Deque source;
+	source.auto_compact(2);
+	Deque constructed(source);
+	Deque assigned;
+	assigned = source;
+	Deque moved(std::move(constructed));
+	Deque swapped;
+	swapped.swap(assigned);
+	Deque *all[] = {&source, &moved, &swapped, &assigned};
+	for (int k = 0; k < 4; ++k) {
+		thin(*all[k]);
+		std::cout << blocks(*all[k]) << " " << intact(*all[k], 24) << std::endl;
+	}
+	Deque plain;
+	source = plain;
+	thin(source);
+	std::cout << blocks(source) << " " << intact(source, 24) << std::endl;
+}
+
+int main()
+{
+	TestCompact();
+	TestAutoCompact();
+	TestFactorTravels();
+	return 0;
+}
@@ -0,0 +1,246 @@
+#include "deque.hpp"
+
+#include <deque>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+unsigned rand_state = 20260;
+
+int next_rand()
+{
+	rand_state = rand_state * 1103515245 + 12345;
+	return int(rand_state >> 8 & 0x7fffff);
+}
+
+template<class Deque, class Model>
+bool same(const Deque &d, const Model &m)
+{
+	if (d.size() != m.size()) return false;
+	if (m.empty()) return true;
+	typename Model::const_iterator jt = m.begin();
+	for (typename Deque::const_iterator it = d.cbegin(); it != d.cend(); ++it, ++jt) {
+		if (*it != *jt) return false;
+	}
+	for (size_t i = 0; i < m.size(); i += 31) {
+		if (d[i] != m[i] || d.at(i) != m[i]) return false;
+	}
+	return d.front() == m.front() && d.back() == m.back();
+}
+
+/**
+ * the tiered engine against std::deque under a random mix of operations at the ends and in the middle.
+ */
+template<class Deque>
+void TestRandom(const char *name)
+{
+	std::cout << "Testing random operations on a tiered deque of " << name << "..." << std::endl;
+	Deque d;
+	std::deque<std::string> m;
+	int checks = 0, bad = 0;
+	for (int step = 0; step < 60000; ++step) {
+		int op = next_rand() % 10;
+		std::string value = std::to_string(step);
+		if (op < 3 || m.empty()) {
+			if (op % 2) {
+				d.push_back(value);
+				m.push_back(value);
+			} else {
+				d.push_front(value);
+				m.push_front(value);
+			}
+		} else if (op < 5) {
+			if (op % 2) {
+				d.pop_back();
+				m.pop_back();
+			} else {
+				d.pop_front();
+				m.pop_front();
+			}
+		} else if (op < 7) {
+			int pos = next_rand() % (m.size() + 1);
+			typename Deque::iterator it = d.insert(d.begin() + pos, value);
+			m.insert(m.begin() + pos, value);
+			if (it - d.begin() != pos || *it != value) ++bad;
+		} else if (op < 9) {
+			int pos = next_rand() % m.size();
+			typename Deque::iterator it = d.erase(d.begin() + pos);
+			m.erase(m.begin() + pos);
+			if (it - d.begin() != pos) ++bad;
+		} else {
+			int pos = next_rand() % (m.size() + 1);
+			typename Deque::iterator it = d.emplace(d.begin() + pos, 3, char('a' + step % 26));
+			m.emplace(m.begin() + pos, 3, char('a' + step % 26));
+			if (*it != m[pos]) ++bad;
+		}
+		if (step % 5000 == 0) {
+			++checks;
+			if (!same(d, m)) ++bad;
+		}
+	}
+	std::cout << d.size() << " " << checks << " " << bad << " " << same(d, m) << std::endl;
+}
+
+/**
+ * trivially copyable elements take the memmove paths of the engine.
+ */
+void TestTrivial()
+{
+	std::cout << "Testing random operations on a tiered deque of ints..." << std::endl;
+	sjtu::deque<int, sjtu::allocator<int>, 0, sjtu::tiered> d;
+	std::deque<int> m;
+	for (int step = 0; step < 200000; ++step) {
+		int op = next_rand() % 8;
+		if (op < 3 || m.empty()) {
+			d.push_back(step);
+			m.push_back(step);
+			d.emplace_front(-step);
+			m.emplace_front(-step);
+		} else if (op < 4) {
+			d.pop_front();
+			m.pop_front();
+		} else if (op < 6) {
+			int pos = next_rand() % (m.size() + 1);
+			d.insert(d.begin() + pos, step);
+			m.insert(m.begin() + pos, step);
+		} else {
+			int pos = next_rand() % m.size();
+			d.erase(d.begin() + pos);
+			m.erase(m.begin() + pos);
+		}
+	}
+	std::cout << d.size() << " " << same(d, m) << std::endl;
+}
+
+template<class Deque>
+void TestIterators()
+{
+	std::cout << "Testing tiered iterators..." << std::endl;
+	Deque d;
+	for (int i = 0; i < 1000; ++i) {
+		d.push_back(std::to_string(i));
+	}
+	typename Deque::iterator it = d.begin();
+	it += 500;
+	typename Deque::iterator jt = it - 200;
+	std::cout << *it << " " << *jt << " " << (it - jt) << " " << (jt - it) << std::endl;
+	++it;
+	it++;
+	--jt;
+	jt--;
+	std::cout << *it << " " << it->size() << " " << *jt << " " << (d.end() - d.begin()) << std::endl;
+	*it = "changed";
+	typename Deque::const_iterator ct = d.cbegin() + 502;
+	std::cout << *ct << " " << (ct == d.cbegin() + 502) << " " << (ct != d.cend()) << std::endl;
+	int count = 0;
+	for (typename Deque::const_iterator kt = d.cend(); kt != d.cbegin();) {
+		--kt;
+		++count;
+	}
+	std::cout << count << std::endl;
+	int thrown = 0;
+	try {
+		*d.end();
+	} catch (...) {
+		++thrown;
+	}
+	Deque other;
+	other.push_back("x");
+	try {
+		d.insert(other.begin(), "y");
+	} catch (...) {
+		++thrown;
+	}
+	try {
+		d.erase(d.end());
+	} catch (...) {
+		++thrown;
+	}
+	try {
+		(void) (d.begin() - other.begin());
+	} catch (...) {
+		++thrown;
+	}
+	std::cout << thrown << std::endl;
+}
+
+template<class Deque>
+void TestCopyAndRanges()
+{
+	std::cout << "Testing tiered copies, range operations and gather..." << std::endl;
+	Deque d;
+	std::deque<std::string> m;
+	for (int i = 0; i < 20000; ++i) {
+		d.push_back(std::to_string(i));
+		m.push_back(std::to_string(i));
+	}
+	Deque copy(d);
+	Deque assigned;
+	assigned.push_back("old");
+	assigned = d;
+	d.clear();
+	std::cout << d.size() << " " << same(copy, m) << " " << same(assigned, m) << std::endl;
+	Deque moved(std::move(copy));
+	std::cout << copy.size() << " " << same(moved, m) << std::endl;
+	moved.swap(d);
+	std::cout << moved.size() << " " << same(d, m) << std::endl;
+
+	std::vector<std::string> run(3000, "r");
+	typename Deque::iterator it = d.insert(d.begin() + 7000, run.begin(), run.end());
+	m.insert(m.begin() + 7000, run.begin(), run.end());
+	std::cout << (it - d.begin()) << " " << same(d, m) << std::endl;
+	it = d.insert(d.begin() + 100, 500, "n");
+	m.insert(m.begin() + 100, 500, "n");
+	std::cout << (it - d.begin()) << " " << same(d, m) << std::endl;
+	it = d.erase(d.begin() + 50, d.begin() + 9000);
+	m.erase(m.begin() + 50, m.begin() + 9000);
+	std::cout << (it - d.begin()) << " " << *it << " " << same(d, m) << std::endl;
+	it = d.erase(d.begin() + 10, d.begin() + 10);
+	std::cout << (it - d.begin()) << " " << same(d, m) << std::endl;
+
+	std::vector<size_t> index;
+	for (size_t i = 0; i < 300; ++i) {
+		index.push_back(i * 7919 % d.size());
+		index.push_back(i);
+	}
+	std::vector<std::string> out;
+	d.gather(index.begin(), index.end(), std::back_inserter(out));
+	int bad = 0;
+	for (size_t i = 0; i < index.size(); ++i) {
+		if (out[i] != m[index[i]]) ++bad;
+	}
+	std::cout << out.size() << " " << bad << std::endl;
+	std::string &front = d.emplace_front(2, 'f');
+	std::string &back = d.emplace_back(2, 'b');
+	std::cout << front << " " << back << " " << d.front() << " " << d.back() << " " << d.size() << std::endl;
+	while (!d.empty()) {
+		d.pop_back();
+	}
+	int thrown = 0;
+	try {
+		d.pop_front();
+	} catch (const sjtu::container_is_empty &) {
+		++thrown;
+	}
+	try {
+		d.at(0);
+	} catch (const sjtu::index_out_of_bound &) {
+		++thrown;
+	}
+	d.push_front("again");
+	std::cout << thrown << " " << d.size() << " " << d.front() << std::endl;
+}
+
+int main()
+{
+	typedef sjtu::deque<std::string, sjtu::allocator<std::string>, 0, sjtu::tiered> Adaptive;
+	typedef sjtu::deque<std::string, sjtu::allocator<std::string>, 64, sjtu::tiered> Pinned;
+	TestRandom<Adaptive>("strings, adaptive tiers");
+	TestRandom<Pinned>("strings, tiers of 64");
+	TestTrivial();
+	TestIterators<Adaptive>();
+	TestCopyAndRanges<Adaptive>();
+	TestCopyAndRanges<Pinned>();
+	return 0;
+}
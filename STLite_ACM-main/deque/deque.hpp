@@ -1,260 +1,799 @@
 #ifndef SJTU_DEQUE_HPP
 #define SJTU_DEQUE_HPP
-#define MERGE_SIZE 500
-#define MERGE_THRESHOLD 240
-#define SPLIT_THRESHOLD 500
 
 #include "exceptions.hpp"
+#include "allocator.hpp"
 #include <iostream>
 #include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace sjtu {
 
-    template<class T>
-    class deque {
-    private:
-        class Element {
-        public:
-            T *data;
-            Element *pre_ele, *nxt_ele;
+    /**
+     * the storage engines deque can be built on, chosen by its last template parameter:
+     *   block_list, the default, is a list of blocks with O(sqrt(n)) random access and block-level
+     *   splice and split; tiered is a tiered vector with O(1) random access (see the specialization below).
+     *   both insert and erase anywhere in O(sqrt(n)) and have the same iterators.
+     */
+    struct block_list {
+    };
 
-            Element(const T &dat) : pre_ele(nullptr), nxt_ele(nullptr) { data = new T(dat); }
+    struct tiered {
+    };
 
-            Element(const Element &element) : pre_ele(nullptr), nxt_ele(nullptr) { data = new T(*(element.data)); }
+    /**
+     * a deque stored as a list of blocks, each a ring buffer of block_size elements.
+     * with BLOCK_SIZE == 0 block_size follows about sqrt(BLOCK_FACTOR * size() / 32): it is a power of two
+     *   in [MIN_BLOCK_SIZE, MAX_BLOCK_SIZE], doubled (or halved) once size() has grown (or shrunk) 4 times
+     *   past the value it suits, and every block is then repacked to the new size in one O(n) pass,
+     *   so the cost is O(1) amortized per operation.
+     * a nonzero BLOCK_SIZE pins block_size and turns the adaptation off.
+     */
+    template<class T, class Alloc = allocator<T>, size_t BLOCK_SIZE = 0, class Engine = block_list>
+    class deque {
+    private:
+        static const int MIN_BLOCK_SIZE = 64;
+        static const int MAX_BLOCK_SIZE = 1 << 14;
 
-            virtual ~Element() {
-                if (data) delete data;
-                data = nullptr;
-            }
-        };
+        /**
+         * a middle insert or erase shifts up to a quarter of a block: a memmove of sizeof(T) bytes per element
+         *   for trivially copyable T, a move and a destructor call per element otherwise. the cheaper the
+         *   shift, the larger the blocks may be (see benchmark.cpp for the sweep these numbers come from).
+         */
+        static const size_t BLOCK_FACTOR = std::is_trivially_copyable<T>::value && sizeof(T) < 16384 ?
+                                           16384 / sizeof(T) : 1;
 
+        /**
+         * a block keeps up to capacity elements in one buffer used as a ring:
+         *   the i-th element (0-base) lives at buf[(head + i) % capacity],
+         *   so in-block access is O(1) and an in-block insert/erase only shifts the shorter side.
+         * a full block splits in halves on insert; a block down to a quarter of its capacity merges with
+         *   a neighbour when the two fit in three quarters of it.
+         * a block does not point back to its deque: the operations that allocate or free blocks are handed
+         *   the deque as origin, so a deque can pass all of its blocks to another one in O(1).
+         *   a header is plain data, and copying it shares the buffer; it is freed by deque::delete_block.
+         */
         class Block {
         public:
             Block *pre_block, *nxt_block;
-            Element *head_ele, *tail_ele;
-            int size_block;
+            T *buf;
+            int capacity, head, size_block;
+            int rank;//position in the block index, meaningful while the index is valid
+            size_t epoch;//bumped when the elements of this block move without the deque epoch changing
 
-            Block() : pre_block(nullptr), nxt_block(nullptr), head_ele(nullptr), tail_ele(nullptr), size_block(0) {}
+            Block(deque *origin, int capacity) : pre_block(nullptr), nxt_block(nullptr),
+                                                 buf(origin->new_buffer(capacity)), capacity(capacity), head(0),
+                                                 size_block(0), rank(0), epoch(0) {}
 
             void display() {
-                int num = 0;
-                std::cout << size_block << ' ';
-                for (Element *ptr = head_ele; ptr; ptr = ptr->nxt_ele) {
-                    std::cout << '*' << ' ';
-                    ++num;
-                }
-                std::cout << (num == size_block) << '\n';
-            }
-
-            Block(const Block &block) : pre_block(block.pre_block), nxt_block(block.nxt_block),
-                                        size_block(block.size_block), tail_ele(nullptr), head_ele(nullptr) {
-                Element *tmp = block.head_ele;
-                while (tmp) {
-                    if (!tail_ele) {
-                        head_ele = new Element(*tmp);
-                        tail_ele = head_ele;
-                    } else {
-                        tail_ele->nxt_ele = new Element(*tmp);
-                        tail_ele->nxt_ele->pre_ele = tail_ele;
-                        tail_ele = tail_ele->nxt_ele;
-                    }
-                    tmp = tmp->nxt_ele;
+                std::cout << size_block << ' ' << head << '\n';
+            }
+
+            Block(const Block &block, deque *origin) : pre_block(nullptr), nxt_block(nullptr),
+                                                       buf(origin->new_buffer(block.capacity)),
+                                                       capacity(block.capacity), head(0), size_block(0),
+                                                       rank(0), epoch(0) {
+                try {
+                    for (; size_block < block.size_block; ++size_block) new(buf + size_block) T(block.at(size_block));
+                } catch (...) {
+                    destroy();
+                    origin->delete_buffer(buf, capacity);
+                    throw;
                 }
             }
 
-            virtual ~Block() {
-                Element *ele = nullptr;
-                while (tail_ele) {
-                    ele = tail_ele;
-                    tail_ele = tail_ele->pre_ele;
-                    delete ele;
+            T *slot(const int &ind) const {//0-base, ind < capacity
+                int pos = head + ind;
+                return buf + (pos >= capacity ? pos - capacity : pos);
+            }
+
+            T &at(const int &ind) const {
+                return *slot(ind);
+            }
+
+            void destroy() {
+                if (!std::is_trivially_destructible<T>::value) {
+                    for (int i = 0; i < size_block; ++i) slot(i)->~T();
                 }
                 size_block = 0;
-                head_ele = tail_ele = nullptr;
-                nxt_block = pre_block = nullptr;
+                head = 0;
             }
 
-            Element *getEle(const int &ind) const {//0-base
-                Element *ele = head_ele;
-                for (int i = 0; i < ind; ++i) {
-                    ele = ele->nxt_ele;
-                }
-                return ele;
+            /**
+             * moves n raw-or-live slots from src to dst (each contiguous), leaving src raw.
+             * the ranges may overlap.
+             */
+            static void move_slots(T *src, int n, T *dst) {
+                move_slots(src, n, dst, std::is_trivially_copyable<T>());
             }
 
-        public:
-            void clear() {
-                Element *ele = nullptr;
-                while (head_ele) {
-                    ele = head_ele;
-                    head_ele = head_ele->nxt_ele;
-                    //                    tail_ele = tail_ele->pre_ele;
-                    delete ele;
+            static void move_slots(T *src, int n, T *dst, std::true_type) {
+                std::memmove(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(T));
+            }
+
+            static void move_slots(T *src, int n, T *dst, std::false_type) {
+                if (dst < src) {
+                    for (int i = 0; i < n; ++i) {
+                        new(dst + i) T(std::move(src[i]));
+                        src[i].~T();
+                    }
+                } else {
+                    for (int i = n - 1; i >= 0; --i) {
+                        new(dst + i) T(std::move(src[i]));
+                        src[i].~T();
+                    }
                 }
-                size_block = 0;
-                head_ele = tail_ele = nullptr;
-                nxt_block = pre_block = nullptr;
             }
 
-            void merge() {//调整被合并（nxt_block）的前后block关于block的信息，并将合并中间的元素连起来，删掉被合并的块
-                if (nxt_block == nullptr) return;
-                else if (nxt_block->size_block == 0) {}
-                else {
-                    size_block += nxt_block->size_block;
-                    if (size_block == 0) {
-                        head_ele = nxt_block->head_ele;
-                        tail_ele = nxt_block->tail_ele;
-                    } else {
-                        nxt_block->head_ele->pre_ele = tail_ele;
-                        tail_ele->nxt_ele = nxt_block->head_ele;
-                        tail_ele = nxt_block->tail_ele;
+            /**
+             * relocates the n elements at [first, first + n) of src to [dest, dest + n) of dst,
+             *   cutting the ranges where either ring wraps.
+             * within one block the copy runs backwards when moving up, so overlapping ranges are safe.
+             */
+            static void relocate(Block *src, int first, int n, Block *dst, int dest) {
+                if (src == dst && dest > first) {
+                    while (n > 0) {
+                        T *s_end = src->slot(first + n - 1) + 1, *d_end = dst->slot(dest + n - 1) + 1;
+                        int len = n;
+                        if (s_end - src->buf < len) len = s_end - src->buf;
+                        if (d_end - dst->buf < len) len = d_end - dst->buf;
+                        move_slots(s_end - len, len, d_end - len);
+                        n -= len;
+                    }
+                } else {
+                    while (n > 0) {
+                        T *s = src->slot(first), *d = dst->slot(dest);
+                        int len = n;
+                        if (src->buf + src->capacity - s < len) len = src->buf + src->capacity - s;
+                        if (dst->buf + dst->capacity - d < len) len = dst->buf + dst->capacity - d;
+                        move_slots(s, len, d);
+                        first += len;
+                        dest += len;
+                        n -= len;
                     }
-                    nxt_block->tail_ele = nxt_block->head_ele = nullptr;
                 }
+            }
+
+            /**
+             * leaves slot ind raw with the elements after it moved up by one,
+             *   shifting whichever side of ind is shorter. the block must not be full.
+             */
+            void open_gap(const int &ind) {
+                if (ind < size_block - ind) {
+                    head = head ? head - 1 : capacity - 1;
+                    relocate(this, 1, ind, this, 0);
+                } else {
+                    relocate(this, ind, size_block - ind, this, ind + 1);
+                }
+                ++size_block;
+            }
+
+            /**
+             * the inverse of open_gap: slot ind is raw and is closed up.
+             */
+            void close_gap(const int &ind) {
+                close_gap(ind, 1);
+            }
+
+            /**
+             * slots [ind, ind + n) are raw and are closed up, again from the shorter side.
+             */
+            void close_gap(const int &ind, const int &n) {
+                if (ind < size_block - n - ind) {
+                    relocate(this, 0, ind, this, n);
+                    head = (head + n) % capacity;
+                } else {
+                    relocate(this, ind + n, size_block - n - ind, this, ind);
+                }
+                size_block -= n;
+            }
+
+            /**
+             * destroys the elements in [first, last) and closes the gap.
+             */
+            void erase(const int &first, const int &last) {
+                if (!std::is_trivially_destructible<T>::value) {
+                    for (int i = first; i < last; ++i) slot(i)->~T();
+                }
+                close_gap(first, last - first);
+            }
+
+            void merge(deque *origin) {//把 nxt_block 的元素接到本块末尾，并删掉被合并的块
+                if (nxt_block == nullptr) return;
+                relocate(nxt_block, 0, nxt_block->size_block, this, size_block);
+                size_block += nxt_block->size_block;
+                nxt_block->size_block = 0;
 
                 Block *temp = nxt_block;
                 nxt_block = nxt_block->nxt_block;
                 if (nxt_block) {
                     nxt_block->pre_block = this;
                 }
-                delete temp;
+                origin->delete_block(temp);
+                origin->index_valid = false;
             }
 
-            void split() {
-                Block *new_block = new Block;
-                new_block->size_block = size_block >> 1;
+            /**
+             * moves the elements from ind on into a new block of the same capacity linked right after this one.
+             */
+            Block *cut(deque *origin, const int &ind) {
+                Block *new_block = origin->new_block(capacity);
                 new_block->pre_block = this;
                 new_block->nxt_block = nxt_block;
-                new_block->tail_ele = tail_ele;
 
                 if (nxt_block) nxt_block->pre_block = new_block;
                 nxt_block = new_block;
-                size_block = size_block >> 1;
-                new_block->head_ele = getEle(size_block);
-                tail_ele = new_block->head_ele->pre_ele;
-                new_block->head_ele->pre_ele = nullptr;
-                tail_ele->nxt_ele = nullptr;
+                relocate(this, ind, size_block - ind, new_block, 0);
+                new_block->size_block = size_block - ind;
+                size_block = ind;
+                origin->index_valid = false;
+                return new_block;
+            }
+
+            void split(deque *origin) {
+                cut(origin, size_block >> 1);
+            }
+
+            /**
+             * merges nxt_block into this block when either of them is down to a quarter of its capacity
+             *   and the two fit in three quarters of the larger buffer, which this block keeps.
+             * returns whether it merged.
+             */
+            bool mend(deque *origin) {
+                Block *nxt = nxt_block;
+                if (!nxt || (size_block > capacity / 4 && nxt->size_block > nxt->capacity / 4)) return false;
+                int sum = size_block + nxt->size_block;
+                if (sum > capacity / 4 * 3) {
+                    if (sum > nxt->capacity / 4 * 3) return false;
+                    // prepend this block to nxt_block, then take over its buffer as in erase
+                    nxt->head = (nxt->head - size_block % nxt->capacity + nxt->capacity) % nxt->capacity;
+                    relocate(this, 0, size_block, nxt, 0);
+                    nxt->size_block = sum;
+                    size_block = 0;
+                    std::swap(buf, nxt->buf);
+                    std::swap(capacity, nxt->capacity);
+                    std::swap(head, nxt->head);
+                    std::swap(size_block, nxt->size_block);
+                }
+                merge(origin);
+                return true;
             }
 
-            int erase(const int &ind) {//////////todo 1or0
+            int erase(deque *origin, const int &ind) {
                 if (!size_block) return 0;
                 if (ind >= size_block || ind < 0) {
-//                    std::cout << "qwer132";///////todo
                     throw index_out_of_bound();
                 }
 
-                if (size_block == 1) {
-                    delete tail_ele;
-                    tail_ele = head_ele = nullptr;
-                } else {
-                    if (!ind) {
-                        Element *element = head_ele;
-                        head_ele = head_ele->nxt_ele;
-                        head_ele->pre_ele = nullptr;
-                        delete element;
-                    } else if (ind == size_block - 1) {
-                        Element *element = tail_ele;
-                        tail_ele = tail_ele->pre_ele;
-                        tail_ele->nxt_ele = nullptr;
-                        delete element;
-                    } else if (ind >= 1 && ind <= size_block - 2) {
-                        Element *element = getEle(ind);
-                        element->nxt_ele->pre_ele = element->pre_ele;
-                        element->pre_ele->nxt_ele = element->nxt_ele;
-                        delete element;
-                    }
-                }
-                --size_block;
-                if (nxt_block && size_block <= MERGE_THRESHOLD &&
-                    size_block + nxt_block->size_block <= MERGE_SIZE) {
-                    merge();
+                slot(ind)->~T();
+                close_gap(ind);
+                if (!size_block && pre_block) {//an empty block is dropped whatever its neighbours hold
+                    pre_block->merge(origin);
+                    return 2;
+                } else if (!size_block && nxt_block) {
+                    // the capacities may differ (after a splice), so take over the buffer of nxt_block
+                    //   and let it carry the empty one away
+                    std::swap(buf, nxt_block->buf);
+                    std::swap(capacity, nxt_block->capacity);
+                    std::swap(head, nxt_block->head);
+                    std::swap(size_block, nxt_block->size_block);
+                    merge(origin);
                     return 1;
-                } else if (pre_block && size_block <= MERGE_THRESHOLD &&
-                           size_block + pre_block->size_block <= MERGE_SIZE) {
-                    pre_block->merge();
+                } else if (nxt_block && size_block <= capacity / 4 &&
+                    size_block + nxt_block->size_block <= capacity / 4 * 3) {
+                    merge(origin);
+                    return 1;
+                } else if (pre_block && size_block <= capacity / 4 &&
+                           size_block + pre_block->size_block <= pre_block->capacity / 4 * 3) {
+                    pre_block->merge(origin);
                     return 2;
                 }
                 return 0;
             }
 
-            bool insert(const int &ind, Element *element) {///////////todo 1or0
+            /**
+             * a full block is split in halves first, and the value goes to whichever half holds ind.
+             * returns whether a split happened.
+             */
+            bool insert(deque *origin, const int &ind, T &&value) {
                 if (ind > size_block || ind < 0) {
-//                    std::cout << "qwer168";///////todo
                     throw index_out_of_bound();
                 }
 
-                if (!size_block) { tail_ele = head_ele = element; }
-                else {
-                    if (!ind) {
-                        element->nxt_ele = head_ele;
-                        head_ele->pre_ele = element;
-                        head_ele = element;
-                    } else if (ind == size_block) {
-                        tail_ele->nxt_ele = element;
-                        element->pre_ele = tail_ele;
-                        tail_ele = element;
-                    } else if (ind >= 0 && ind < size_block) {
-                        Element *ele = getEle(ind);
-                        element->pre_ele = ele->pre_ele;
-                        element->nxt_ele = ele;
-                        ele->pre_ele->nxt_ele = element;
-                        ele->pre_ele = element;
-                    }
-                }
-                ++size_block;
-                if (size_block >= SPLIT_THRESHOLD) {
-                    split();
+                if (size_block == capacity) {
+                    split(origin);
+                    if (ind > size_block) nxt_block->insert(origin, ind - size_block, std::move(value));
+                    else insert(origin, ind, std::move(value));
                     return true;
                 }
+                open_gap(ind);
+                try {
+                    new(slot(ind)) T(std::move(value));
+                } catch (...) {
+                    close_gap(ind);
+                    throw;
+                }
                 return false;
             }
         };
 
     private:
+        typedef std::allocator_traits<Alloc> alloc_traits;
+
         int size_deque, num_block;
         Block *head_block, *tail_block;
+        Alloc alloc;
+
+        /**
+         * block headers come from a per-deque slab pool carved out of alloc: erased blocks are recycled
+         *   by later splits, and the slabs are released as a whole by clear() and the destructor.
+         * the element buffers of the blocks are taken from alloc directly.
+         */
+        slab_pool<Block, Alloc> block_pool;
+
+        /**
+         * the block index: blocks[i] is the i-th block and tree is a Fenwick tree (1-base) over their sizes,
+         *   so a position is located in O(log num_block). the head block counts as empty in the tree:
+         *   positions inside it are answered directly, so the front of the deque changes without touching
+         *   the tree, and a change to the tail block touches a single entry of it.
+         * plain size changes update the tree in O(log num_block); a split or merge reorders the blocks and only
+         *   marks the index stale, and the next lookup rebuilds it in O(num_block). splits and merges are
+         *   at least O(block_size) operations apart, so the rebuilds are amortized away.
+         */
+        typedef typename alloc_traits::template rebind_alloc<Block *> block_ptr_allocator;
+        typedef typename alloc_traits::template rebind_alloc<int> int_allocator;
+
+        mutable Block **blocks;
+        mutable int *tree;
+        mutable int index_capacity, index_top;
+        mutable bool index_valid;
+
+        /**
+         * iterators record the deque epoch and the epoch of their block when they locate it.
+         * the deque epoch is bumped by anything that can shift elements across blocks or free a block:
+         *   inserts and erases outside the tail block, splits, merges, clear and assignment.
+         * an insert or erase inside the tail block only moves elements of that block, so it bumps the
+         *   epoch of the tail block alone, and iterators into the other blocks stay current.
+         * while both epochs match, an iterator's block is alive and its index in it is right.
+         */
+        size_t epoch;
+
+        /**
+         * the capacity of every block, and the sizes at which it is adapted next.
+         */
+        int block_size;
+        size_t grow_at, shrink_at;
+
+        /**
+         * the last block drained at either end, kept for the next end push that needs a block,
+         *   so queue traffic at a block boundary does not allocate and free a block every time.
+         */
+        Block *spare_block;
+
+        /**
+         * with a nonzero compact_factor the deque compacts itself once it has more than
+         *   compact_factor times the blocks it would need packed (see auto_compact).
+         * it is a setting of the deque, and copies, moves and swaps carry it along with the elements.
+         */
+        size_t compact_factor;
+
+        template<class U, class... Args>
+        static U *create(slab_pool<U, Alloc> &pool, Args &&... args) {
+            U *p = pool.allocate();
+            try {
+                new(p) U(std::forward<Args>(args)...);
+            } catch (...) {
+                pool.deallocate(p);
+                throw;
+            }
+            return p;
+        }
+
+        T *new_buffer(int capacity) {
+            return alloc_traits::allocate(alloc, capacity);
+        }
+
+        void delete_buffer(T *buf, int capacity) {
+            alloc_traits::deallocate(alloc, buf, capacity);
+        }
+
+        Block *new_block() {
+            return create(block_pool, this, block_size);
+        }
+
+        Block *new_block(int capacity) {
+            return create(block_pool, this, capacity);
+        }
+
+        void delete_block(Block *block) {
+            block->destroy();
+            delete_buffer(block->buf, block->capacity);
+            block_pool.deallocate(block);
+        }
+
+        void rebuild_index() const {
+            int m = 0;
+            for (Block *block = head_block; block; block = block->nxt_block) ++m;
+            if (m > index_capacity) {
+                free_index();
+                index_capacity = m * 2;
+                block_ptr_allocator block_alloc(alloc);
+                int_allocator int_alloc(alloc);
+                blocks = std::allocator_traits<block_ptr_allocator>::allocate(block_alloc, index_capacity);
+                tree = std::allocator_traits<int_allocator>::allocate(int_alloc, index_capacity + 1);
+            }
+            m = 0;
+            for (Block *block = head_block; block; block = block->nxt_block) {
+                block->rank = m;
+                blocks[m++] = block;
+                tree[m] = block == head_block ? 0 : block->size_block;
+            }
+            for (int i = 1; i <= m; ++i) {
+                int j = i + (i & -i);
+                if (j <= m) tree[j] += tree[i];
+            }
+            index_top = 1;
+            while (index_top * 2 <= m) index_top *= 2;
+            const_cast<deque *>(this)->num_block = m;
+            index_valid = true;
+        }
+
+        void free_index() const {
+            if (!blocks) return;
+            block_ptr_allocator block_alloc(alloc);
+            int_allocator int_alloc(alloc);
+            std::allocator_traits<block_ptr_allocator>::deallocate(block_alloc, blocks, index_capacity);
+            std::allocator_traits<int_allocator>::deallocate(int_alloc, tree, index_capacity + 1);
+            blocks = nullptr;
+            tree = nullptr;
+            index_capacity = 0;
+        }
+
+        /**
+         * records that block gained (or lost) delta elements without any block being split or merged.
+         */
+        void index_add(Block *block, int delta) {
+            if (!index_valid || block == head_block) return;
+            for (int i = block->rank + 1; i <= num_block; i += i & -i) tree[i] += delta;
+        }
+
+        template<class Iter>
+        void locate(Iter &it) const {
+            it.block = getBlock(it.ind_deque, it.ind_block);
+            it.epoch = epoch;
+            it.block_epoch = it.block ? it.block->epoch : 0;
+        }
+
+        template<class Iter>
+        static bool current(const Iter &it) {
+            return it.epoch == it.origin->epoch && (!it.block || it.block->epoch == it.block_epoch);
+        }
+
+        /**
+         * an iterator is valid when its position still maps to the block and in-block index it holds.
+         * that is O(1) while its epochs are current; otherwise the position is located again and compared.
+         */
+        template<class Iter>
+        bool valid(const Iter &it) const {
+            if (it.ind_deque > size_deque) return false;
+            if (current(it)) return true;
+            int index_block;
+            Block *block = getBlock(it.ind_deque, index_block);
+            return block == it.block && index_block == it.ind_block;
+        }
+
+        /**
+         * moves it by n positions (it.ind_deque is already updated). short moves of a current iterator step
+         *   along the block list, skipping whole blocks by their sizes; longer ones, or ones from a stale
+         *   iterator, go through the index.
+         */
+        template<class Iter>
+        void step(Iter &it, const int &n) const {
+            if (!it.block || !current(it) || n > block_size || -n > block_size) {
+                locate(it);
+                return;
+            }
+            it.ind_block += n;
+            while (it.ind_block >= it.block->size_block && it.block->nxt_block) {
+                it.ind_block -= it.block->size_block;
+                it.block = it.block->nxt_block;
+            }
+            while (it.ind_block < 0) {
+                it.block = it.block->pre_block;
+                it.ind_block += it.block->size_block;
+            }
+            it.block_epoch = it.block->epoch;
+        }
+
+        static int initial_block_size() {
+            return BLOCK_SIZE ? int(BLOCK_SIZE) : MIN_BLOCK_SIZE;
+        }
+
+        /**
+         * the smallest power of two at least MIN_BLOCK_SIZE with 32 * size * size >= BLOCK_FACTOR * n,
+         *   capped at MAX_BLOCK_SIZE.
+         */
+        static int ideal_block_size(size_t n) {
+            size_t size = MIN_BLOCK_SIZE;
+            while (size < MAX_BLOCK_SIZE && 32 * size * size < BLOCK_FACTOR * n) size *= 2;
+            return int(size);
+        }
+
+        void set_block_size(int size) {
+            block_size = size;
+            if (BLOCK_SIZE) {
+                grow_at = size_t(-1);
+                shrink_at = 0;
+                return;
+            }
+            grow_at = size < MAX_BLOCK_SIZE ? 64 * size_t(size) * size / BLOCK_FACTOR : size_t(-1);
+            shrink_at = size > MIN_BLOCK_SIZE ? 4 * size_t(size) * size / BLOCK_FACTOR : 0;
+        }
+
+        /**
+         * called after every change of size: once the size has left [shrink_at, grow_at],
+         *   every element is repacked into full blocks of the new block size.
+         */
+        void adapt() {
+            if (size_t(size_deque) > grow_at || size_t(size_deque) < shrink_at) {
+                int size = ideal_block_size(size_deque);
+                if (size != block_size) {
+                    repack(size);
+                    return;
+                }
+                set_block_size(size);
+            }
+            if (sparse()) repack(block_size);
+        }
+
+        /**
+         * whether auto compaction is on and the blocks outnumber compact_factor times the count
+         *   a packed deque of this size would have.
+         */
+        bool sparse() const {
+            return compact_factor && size_t(num_block) > compact_factor * (size_deque / block_size + 1);
+        }
+
+        /**
+         * moves every element into a fresh chain of full blocks of the given capacity, O(n).
+         * the new chain is allocated up front, so only the relocations remain once old blocks are touched.
+         */
+        void repack(int size) {
+            drop_spare();
+            int old_size = block_size;
+            int count = (size_deque + size - 1) / size;
+            if (!count) count = 1;
+            set_block_size(size);
+            Block *first = nullptr, *last = nullptr;
+            try {
+                for (int i = 0; i < count; ++i) {
+                    Block *block = new_block();
+                    block->pre_block = last;
+                    if (last) last->nxt_block = block;
+                    else first = block;
+                    last = block;
+                }
+            } catch (...) {
+                while (first) {
+                    Block *nxt = first->nxt_block;
+                    delete_block(first);
+                    first = nxt;
+                }
+                set_block_size(old_size);
+                throw;
+            }
+            Block *dst = first;
+            while (head_block) {
+                Block *src = head_block;
+                int moved = 0;
+                while (moved < src->size_block) {
+                    if (dst->size_block == dst->capacity) dst = dst->nxt_block;
+                    int len = src->size_block - moved;
+                    if (dst->capacity - dst->size_block < len) len = dst->capacity - dst->size_block;
+                    Block::relocate(src, moved, len, dst, dst->size_block);
+                    dst->size_block += len;
+                    moved += len;
+                }
+                src->size_block = 0;
+                head_block = src->nxt_block;
+                delete_block(src);
+            }
+            head_block = first;
+            tail_block = last;
+            num_block = count;
+            index_valid = false;
+            ++epoch;
+        }
+
+        void drop_spare() {
+            if (spare_block) delete_block(spare_block);
+            spare_block = nullptr;
+        }
+
+        Block *end_block() {
+            Block *block = spare_block;
+            spare_block = nullptr;
+            return block ? block : new_block();
+        }
+
+        /**
+         * unlinks a drained block at either end and keeps it as the spare; the previous spare is freed.
+         */
+        void retire(Block *block) {
+            block->pre_block = block->nxt_block = nullptr;
+            block->head = 0;
+            drop_spare();
+            spare_block = block;
+            --num_block;
+            ++epoch;
+        }
+
+        /**
+         * constructs an end element in block; if that throws, a fresh (still unlinked) block goes back
+         *   to being the spare.
+         */
+        template<class... Args>
+        void construct(Block *block, T *pos, bool fresh, Args &&... args) {
+            try {
+                new(pos) T(std::forward<Args>(args)...);
+            } catch (...) {
+                if (fresh) {
+                    drop_spare();
+                    spare_block = block;
+                }
+                throw;
+            }
+        }
+
+        /**
+         * moves the blocks from block to the end of the chain of other into this deque between left and right,
+         *   copying their headers into this deque's pool; the elements and buffers stay where they are,
+         *   so both deques must share an allocator. empty blocks are freed instead.
+         * the new headers are taken first, so if that throws nothing has changed. otherwise the chain
+         *   is left dangling in other, which must unlink it. returns the number of elements moved.
+         */
+        int adopt(deque &other, Block *block, Block *left, Block *right) {
+            Block *first = nullptr, *last = nullptr;
+            int count = 0, moved = 0;
+            for (Block *src = block; src; src = src->nxt_block) {
+                if (!src->size_block) continue;
+                Block *dst;
+                try {
+                    dst = block_pool.allocate();
+                } catch (...) {
+                    while (first) {
+                        Block *nxt = first->nxt_block;
+                        block_pool.deallocate(first);
+                        first = nxt;
+                    }
+                    throw;
+                }
+                new(dst) Block(*src);
+                dst->pre_block = last;
+                dst->nxt_block = nullptr;
+                if (last) last->nxt_block = dst;
+                else first = dst;
+                last = dst;
+                ++count;
+                moved += src->size_block;
+            }
+            while (block) {
+                Block *nxt = block->nxt_block;
+                if (block->size_block) other.block_pool.deallocate(block);
+                else other.delete_block(block);
+                block = nxt;
+            }
+            if (!first) return 0;
+            first->pre_block = left;
+            last->nxt_block = right;
+            if (left) left->nxt_block = first;
+            else head_block = first;
+            if (right) right->pre_block = last;
+            else tail_block = last;
+            num_block += count;
+            size_deque += moved;
+            index_valid = false;
+            ++epoch;
+            mend(last);
+            mend(left);
+            return moved;
+        }
+
+        void mend(Block *block) {
+            if (!block || !block->nxt_block) return;
+            Block *nxt = block->nxt_block;
+            if (!block->mend(this)) return;
+            --num_block;
+            if (nxt == tail_block) tail_block = block;
+        }
+
+        /**
+         * after a splice the size may jump past the adaptation thresholds; rather than repacking,
+         *   only the size of new blocks is retuned. blocks of other sizes stay as they are
+         *   until the next repack.
+         */
+        void retune() {
+            if (size_t(size_deque) > grow_at || size_t(size_deque) < shrink_at) {
+                set_block_size(ideal_block_size(size_deque));
+            }
+            if (sparse()) repack(block_size);
+        }
+
+        /**
+         * an empty deque for building a run of elements to splice into a deque with blocks of the given size:
+         *   its blocks all have that capacity and the adaptation is off, so the run comes out packed.
+         */
+        deque(const Alloc &alloc, int size) : size_deque(0), num_block(1), alloc(alloc), block_pool(alloc),
+                                              blocks(nullptr), tree(nullptr), index_capacity(0), index_top(0),
+                                              index_valid(false), epoch(0), block_size(size), grow_at(size_t(-1)),
+                                              shrink_at(0), spare_block(nullptr), compact_factor(0) {
+            head_block = new_block();
+            tail_block = head_block;
+        }
+
+        /**
+         * unlinks block and frees it along with its elements.
+         */
+        void unlink(Block *block) {
+            if (block->pre_block) block->pre_block->nxt_block = block->nxt_block;
+            else head_block = block->nxt_block;
+            if (block->nxt_block) block->nxt_block->pre_block = block->pre_block;
+            else tail_block = block->pre_block;
+            size_deque -= block->size_block;
+            --num_block;
+            delete_block(block);
+        }
+
+        void copy_blocks(const deque &other) {
+            Block *block = other.head_block;
+            while (block) {
+                if (!head_block) {
+                    tail_block = create(block_pool, *block, this);
+                    head_block = tail_block;
+                } else {
+                    tail_block->nxt_block = create(block_pool, *block, this);
+                    tail_block->nxt_block->pre_block = tail_block;
+                    tail_block = tail_block->nxt_block;
+                }
+                block = block->nxt_block;
+            }
+        }
+
     public:
         class const_iterator;
 
         class iterator {
-            friend class deque<T>;
+            friend class deque;
 
         private:
             /**
              * add data members
              *   just add whatever you want.
              */
-            deque<T> *origin;
+            deque *origin;
             Block *block;
-            Element *ele;
             int ind_deque, ind_block;
+            size_t epoch, block_epoch;
 
         public:
-            iterator() : origin(nullptr), block(nullptr), ele(nullptr), ind_block(0), ind_deque(0) {}
+            iterator() : origin(nullptr), block(nullptr), ind_deque(0), ind_block(0), epoch(0), block_epoch(0) {}
 
-            iterator(const iterator &iter) : origin(iter.origin), block(iter.block), ele(iter.ele),
-                                             ind_deque(iter.ind_deque), ind_block(iter.ind_block) {}
+            iterator(const iterator &iter) : origin(iter.origin), block(iter.block),
+                                             ind_deque(iter.ind_deque), ind_block(iter.ind_block),
+                                             epoch(iter.epoch), block_epoch(iter.block_epoch) {}
 
-            iterator(int index_deque, deque<T> *deq) : origin(deq), ind_deque(index_deque) {
+            iterator(int index_deque, deque *deq) : origin(deq), ind_deque(index_deque) {
                 if (index_deque > origin->size_deque)
                     throw invalid_iterator();
-                if (index_deque == origin->size_deque) {
-                    block = origin->tail_block;
-                    if (block) ind_block = block->size_block;
-                    ele = nullptr;
-                } else {
-                    ele = deq->getElement(ind_deque, block, ind_block);
-                }
+                deq->locate(*this);
             }
 
             bool isValid() const {
-                if (!ind_deque) return true;
-                int index_block;
-                Block *bb;
-                Element *ee;
-                ee = origin->getElement(ind_deque, bb, index_block);
-                if (ee != ele || bb != block || index_block != ind_block) return false;
-                return true;
+                return origin->valid(*this);
             }
 
             /**
@@ -290,7 +829,7 @@ namespace sjtu {
                 if (n < 0) return *this -= (-n);
                 if (ind_deque + n > origin->size_deque) throw invalid_iterator();///todo
                 ind_deque += n;
-                ele = origin->getElement(ind_deque, block, ind_block);
+                origin->step(*this, n);
                 return *this;
             }
 
@@ -298,7 +837,7 @@ namespace sjtu {
                 if (n < 0) return *this += (-n);
                 if (ind_deque - n < 0) throw invalid_iterator();///todo
                 ind_deque -= n;
-                ele = origin->getElement(ind_deque, block, ind_block);
+                origin->step(*this, -n);
                 return *this;
             }
 
@@ -325,13 +864,13 @@ namespace sjtu {
             }
 
             T &operator*() const {
-                if (!ele || !(ele->data) || !isValid()) throw invalid_iterator();
-                return *(ele->data);
+                if (!origin || ind_deque >= origin->size_deque || !isValid()) throw invalid_iterator();
+                return block->at(ind_block);
             }
 
             T *operator->() const noexcept {
-                if (!ele || !(ele->data) || !isValid()) throw invalid_iterator();
-                return ele->data;
+                if (!origin || ind_deque >= origin->size_deque || !isValid()) throw invalid_iterator();
+                return &block->at(ind_block);
             }
 
             /**
@@ -365,41 +904,34 @@ namespace sjtu {
         class const_iterator {
             // it should has similar member method as iterator.
             //  and it should be able to construct from an iterator.
-            friend class deque<T>;
+            friend class deque;
 
         private:
             // data members.
-            const deque<T> *origin;
+            const deque *origin;
             Block *block;
-            Element *ele;
             int ind_deque, ind_block;
+            size_t epoch, block_epoch;
         public:
-            const_iterator() : origin(nullptr), block(nullptr), ele(nullptr), ind_block(0), ind_deque(0) {}
+            const_iterator() : origin(nullptr), block(nullptr), ind_deque(0), ind_block(0), epoch(0),
+                               block_epoch(0) {}
 
-            const_iterator(const const_iterator &other) : origin(other.origin), block(other.block), ele(other.ele),
-                                                          ind_deque(other.ind_deque), ind_block(other.ind_block) {}
+            const_iterator(const const_iterator &other) : origin(other.origin), block(other.block),
+                                                          ind_deque(other.ind_deque), ind_block(other.ind_block),
+                                                          epoch(other.epoch), block_epoch(other.block_epoch) {}
 
-            const_iterator(const iterator &other) : origin(other.origin), block(other.block), ele(other.ele),
-                                                    ind_deque(other.ind_deque), ind_block(other.ind_block) {}
+            const_iterator(const iterator &other) : origin(other.origin), block(other.block),
+                                                    ind_deque(other.ind_deque), ind_block(other.ind_block),
+                                                    epoch(other.epoch), block_epoch(other.block_epoch) {}
 
-            const_iterator(int index_deque, const deque<T> *deq) : origin(deq), ind_deque(index_deque) {
+            const_iterator(int index_deque, const deque *deq) : origin(deq), ind_deque(index_deque) {
                 if (index_deque > origin->size_deque)
                     throw invalid_iterator();
-                if (index_deque == origin->size_deque) {
-                    block = origin->tail_block;
-                    ind_block = block->size_block;
-                } else {
-                    ele = deq->getElement(ind_deque, block, ind_block);
-                }
+                deq->locate(*this);
             }
 
             bool isValid() const {
-                int index_block;
-                Block *bb;
-                Element *ee;
-                ee = origin->getElement(ind_deque, bb, index_block);
-                if (ee != ele || bb != block || index_block != ind_block) return false;
-                return true;
+                return origin->valid(*this);
             }
 
             /**
@@ -435,7 +967,7 @@ namespace sjtu {
                 if (n < 0) return *this -= (-n);
                 if (ind_deque + n > origin->size_deque) throw invalid_iterator();///todo
                 ind_deque += n;
-                ele = origin->getElement(ind_deque, block, ind_block);
+                origin->step(*this, n);
                 return *this;
             }
 
@@ -443,7 +975,7 @@ namespace sjtu {
                 if (n < 0) return *this += (-n);
                 if (ind_deque - n < 0) throw invalid_iterator();///todo
                 ind_deque -= n;
-                ele = origin->getElement(ind_deque, block, ind_block);
+                origin->step(*this, -n);
                 return *this;
             }
 
@@ -470,13 +1002,13 @@ namespace sjtu {
             }
 
             const T &operator*() const {
-                if (!ele || !(ele->data) || !isValid()) throw invalid_iterator();
-                return *(ele->data);
+                if (!origin || ind_deque >= origin->size_deque || !isValid()) throw invalid_iterator();
+                return block->at(ind_block);
             }
 
             const T *operator->() const noexcept {
-                if (!ele || !(ele->data) || !isValid()) throw invalid_iterator();
-                return ele->data;
+                if (!origin || ind_deque >= origin->size_deque || !isValid()) throw invalid_iterator();
+                return &block->at(ind_block);
             }
 
             /**
@@ -509,48 +1041,75 @@ namespace sjtu {
         /**
          * Constructors
          */
-        deque() : size_deque(0), num_block(1) {
-            head_block = new Block();
+        deque() : size_deque(0), num_block(1), alloc(), block_pool(alloc), blocks(nullptr), tree(nullptr),
+                  index_capacity(0), index_top(0), index_valid(false), epoch(0), spare_block(nullptr),
+                  compact_factor(0) {
+            set_block_size(initial_block_size());
+            head_block = new_block();
+            tail_block = head_block;
+        }
+
+        /**
+         * an empty deque drawing all of its memory from alloc.
+         */
+        explicit deque(const Alloc &alloc) : size_deque(0), num_block(1), alloc(alloc), block_pool(alloc),
+                                             blocks(nullptr), tree(nullptr), index_capacity(0), index_top(0),
+                                             index_valid(false), epoch(0), spare_block(nullptr),
+                                             compact_factor(0) {
+            set_block_size(initial_block_size());
+            head_block = new_block();
             tail_block = head_block;
         }
 
         deque(const deque &other) : size_deque(other.size_deque), num_block(other.num_block), head_block(nullptr),
-                                    tail_block(
-                                            nullptr) {
-            Block *block = other.head_block;
-            while (block) {
-                if (!head_block) {
-                    tail_block = new Block(*block);
-                    head_block = tail_block;
-                } else {
-                    tail_block->nxt_block = new Block(*block);
-                    tail_block->nxt_block->pre_block = tail_block;
-                    tail_block = tail_block->nxt_block;
-                }
-                block = block->nxt_block;
-            }
+                                    tail_block(nullptr), alloc(other.alloc), block_pool(alloc),
+                                    blocks(nullptr), tree(nullptr), index_capacity(0), index_top(0),
+                                    index_valid(false), epoch(0), block_size(other.block_size),
+                                    grow_at(other.grow_at), shrink_at(other.shrink_at), spare_block(nullptr),
+                                    compact_factor(other.compact_factor) {
+            copy_blocks(other);
+        }
+
+        /**
+         * takes over the blocks of other, leaving it empty. O(1).
+         * iterators into other are invalidated.
+         */
+        deque(deque &&other) noexcept : size_deque(0), num_block(1), head_block(nullptr), tail_block(nullptr),
+                                        alloc(other.alloc), block_pool(alloc), blocks(nullptr), tree(nullptr),
+                                        index_capacity(0), index_top(0), index_valid(false), epoch(0),
+                                        spare_block(nullptr), compact_factor(0) {
+            set_block_size(initial_block_size());
+            swap(other);
         }
 
         void init() {
             size_deque = 0;
             num_block = 1;
-            head_block = new Block();
+            head_block = new_block();
             tail_block = head_block;
+            index_valid = false;
+            ++epoch;
         }
 
         /**
          * clears the contents
          */
         void clear() {
+            drop_spare();
             Block *tmp;
             while (head_block) {
                 tmp = head_block;
                 head_block = head_block->nxt_block;
-                delete tmp;
+                delete_block(tmp);
             }
+            // every block is destroyed, hand the slabs back wholesale
+            block_pool.release();
             tail_block = head_block = nullptr;
             num_block = 1;
             size_deque = 0;
+            index_valid = false;
+            ++epoch;
+            set_block_size(initial_block_size());
         }
 
         /**
@@ -558,44 +1117,36 @@ namespace sjtu {
          */
         ~deque() {
             clear();
+            free_index();
         }
 
-        Element *getElement(const int &index_deque, Block *&block, int &index_block) const {
+        /**
+         * the block holding index_deque and its index inside it; index_deque == size() gives the tail block
+         *   and the position one past its last element.
+         */
+        Block *getBlock(const int &index_deque, int &index_block) const {
             if (index_deque == size_deque) {
-                index_block = tail_block->size_block;
-                block = tail_block;
-                return nullptr;
+                index_block = tail_block ? tail_block->size_block : 0;
+                return tail_block;
             }
             if (index_deque == size_deque - 1) {
                 index_block = tail_block->size_block - 1;
-                block = tail_block;
-                return tail_block->tail_ele;
-            }
-            index_block = index_deque;
-            block = head_block;
-            while (index_block >= block->size_block) {
-                index_block -= block->size_block;
-                block = block->nxt_block;
+                return tail_block;
             }
-            return block->getEle(index_block);
-        }
-
-        Block *getBlock(const int &index_deque, int &index_block) const {
-            if (!size_deque) {
-                index_block = 0;
+            if (index_deque < head_block->size_block) {
+                index_block = index_deque;
                 return head_block;
             }
-            if (index_deque == size_deque - 1) {
-                index_block = tail_block->size_block - 1;
-                return tail_block;
-            }
-            index_block = index_deque;
-            Block *tmp = head_block;
-            while (index_block >= tmp->size_block) {
-                index_block -= tmp->size_block;
-                tmp = tmp->nxt_block;
+            if (!index_valid) rebuild_index();
+            int pos = 0;
+            index_block = index_deque - head_block->size_block;
+            for (int step = index_top; step; step >>= 1) {
+                if (pos + step <= num_block && tree[pos + step] <= index_block) {
+                    pos += step;
+                    index_block -= tree[pos];
+                }
             }
-            return tmp;
+            return blocks[pos];
         }
 
         /**
@@ -604,23 +1155,52 @@ namespace sjtu {
         deque &operator=(const deque &other) {
             if (this == &other) return *this;
             clear();
-            Block *block = other.head_block;
             num_block = other.num_block;
             size_deque = other.size_deque;
-            while (block) {
-                if (!head_block) {
-                    tail_block = new Block(*block);
-                    head_block = tail_block;
-                } else {
-                    tail_block->nxt_block = new Block(*block);
-                    tail_block->nxt_block->pre_block = tail_block;
-                    tail_block = tail_block->nxt_block;
-                }
-                block = block->nxt_block;
-            }
+            ++epoch;
+            block_size = other.block_size;
+            grow_at = other.grow_at;
+            shrink_at = other.shrink_at;
+            compact_factor = other.compact_factor;
+            copy_blocks(other);
+            return *this;
+        }
+
+        /**
+         * the allocator travels with the blocks.
+         */
+        deque &operator=(deque &&other) noexcept {
+            if (this == &other) return *this;
+            deque tmp(std::move(other));
+            swap(tmp);
             return *this;
         }
 
+        /**
+         * exchanges the contents (and allocators) of the two deques in O(1).
+         * iterators of both deques are invalidated.
+         */
+        void swap(deque &other) noexcept {
+            std::swap(size_deque, other.size_deque);
+            std::swap(num_block, other.num_block);
+            std::swap(head_block, other.head_block);
+            std::swap(tail_block, other.tail_block);
+            std::swap(alloc, other.alloc);
+            block_pool.swap(other.block_pool);
+            std::swap(blocks, other.blocks);
+            std::swap(tree, other.tree);
+            std::swap(index_capacity, other.index_capacity);
+            std::swap(index_top, other.index_top);
+            std::swap(index_valid, other.index_valid);
+            std::swap(block_size, other.block_size);
+            std::swap(grow_at, other.grow_at);
+            std::swap(shrink_at, other.shrink_at);
+            std::swap(spare_block, other.spare_block);
+            std::swap(compact_factor, other.compact_factor);
+            // a fresh epoch on both sides, so no iterator takes the other deque's blocks for its own
+            epoch = other.epoch = (epoch > other.epoch ? epoch : other.epoch) + 1;
+        }
+
         /**
          * access specified element with bounds checking
          * throw index_out_of_bound if out of bound.
@@ -630,11 +1210,9 @@ namespace sjtu {
 //                std::cout << "qwer625";///////todo
                 throw index_out_of_bound();
             }
-            Block *block;
-            Element *ele;
             int ind;
-            ele = getElement(pos, block, ind);
-            return *(ele->data);
+            Block *block = getBlock(pos, ind);
+            return block->at(ind);
         }
 
         const T &at(const size_t &pos) const {
@@ -642,11 +1220,9 @@ namespace sjtu {
 //                std::cout << "qwer643";///////todo
                 throw index_out_of_bound();
             }
-            Block *block;
-            Element *ele;
             int ind;
-            ele = getElement(pos, block, ind);
-            return *(ele->data);
+            Block *block = getBlock(pos, ind);
+            return block->at(ind);
         }
 
         T &operator[](const size_t &pos) {
@@ -654,11 +1230,9 @@ namespace sjtu {
 //                std::cout << "qwer655";///////todo
                 throw index_out_of_bound();
             }
-            Block *block;
-            Element *ele;
             int ind;
-            ele = getElement(pos, block, ind);
-            return *(ele->data);
+            Block *block = getBlock(pos, ind);
+            return block->at(ind);
         }
 
         const T &operator[](const size_t &pos) const {
@@ -666,11 +1240,51 @@ namespace sjtu {
 //                std::cout << "qwer667";///////todo
                 throw index_out_of_bound();
             }
-            Block *block;
-            Element *ele;
             int ind;
-            ele = getElement(pos, block, ind);
-            return *(ele->data);
+            Block *block = getBlock(pos, ind);
+            return block->at(ind);
+        }
+
+        /**
+         * writes the elements at the positions in [first, last) to out, in the order the positions come in,
+         *   and returns out past the last one written.
+         * positions in ascending order are resolved in one forward sweep over the blocks, O(num_block + k).
+         *   otherwise each one goes through the block index, O(k log num_block), which beats sorting them first.
+         * [first, last) must be a multi-pass range of values convertible to size_t.
+         * throw index_out_of_bound, before anything is written, if a position is not below size().
+         */
+        template<class IndexIt, class OutputIt>
+        OutputIt gather(IndexIt first, IndexIt last, OutputIt out) const {
+            size_t k = 0;
+            bool sorted = true;
+            size_t pre = 0;
+            for (IndexIt it = first; it != last; ++it, ++k) {
+                size_t index = *it;
+                if (index >= size_t(size_deque)) throw index_out_of_bound();
+                if (index < pre) sorted = false;
+                pre = index;
+            }
+            if (!k) return out;
+            if (sorted) {
+                Block *block = head_block;
+                size_t offset = 0;
+                for (; first != last; ++first) {
+                    size_t index = *first;
+                    while (index >= offset + block->size_block) {
+                        offset += block->size_block;
+                        block = block->nxt_block;
+                    }
+                    *out = block->at(int(index - offset));
+                    ++out;
+                }
+                return out;
+            }
+            for (; first != last; ++first, ++out) {
+                int ind;
+                Block *found = getBlock(int(*first), ind);
+                *out = found->at(ind);
+            }
+            return out;
         }
 
         /**
@@ -682,7 +1296,7 @@ namespace sjtu {
 //                std::cout << "665smsp";//////////todo
                 throw container_is_empty();
             }
-            return *(head_block->head_ele->data);
+            return head_block->at(0);
         }
 
         /**
@@ -694,7 +1308,7 @@ namespace sjtu {
 //                std::cout << "674smsp";//////////todo
                 throw container_is_empty();
             }
-            return *(tail_block->tail_ele->data);
+            return tail_block->at(tail_block->size_block - 1);
         }
 
         /**
@@ -747,33 +1361,42 @@ namespace sjtu {
          *     throw if the iterator is invalid or it point to a wrong place.
          */
         iterator insert(iterator pos, const T &value) {
+            return emplace(pos, value);
+        }
+
+        iterator insert(iterator pos, T &&value) {
+            return emplace(pos, std::move(value));
+        }
+
+        /**
+         * constructs an element from args before pos.
+         * the element is built before anything moves, so args may refer to elements of this deque.
+         * returns an iterator pointing to the new element.
+         */
+        template<class... Args>
+        iterator emplace(iterator pos, Args &&... args) {
             if (pos.origin != this || !pos.isValid()) throw invalid_iterator();
-            if (pos.ind_deque < 0 || pos.ind_block > size_deque) {
+            if (pos.ind_deque < 0 || pos.ind_deque > size_deque) {
 //                std::cout << "qwer758";///////todo
                 throw index_out_of_bound();
             }
+            T value(std::forward<Args>(args)...);
             if (!head_block) init();
 
-            auto *ele = new Element(value);
-            Block *block;
             int index_block;
-            if (pos.ind_deque == size_deque) {
-                if (tail_block->insert(tail_block->size_block, ele)) {
-                    ++num_block;
-                    tail_block = tail_block->nxt_block;
-                }
+            Block *block = getBlock(pos.ind_deque, index_block);
+            if (block->insert(this, index_block, std::move(value))) {
+                ++num_block;
+                if (block == tail_block) tail_block = block->nxt_block;
+                ++epoch;
             } else {
-                block = getBlock(pos.ind_deque, index_block);
-                if (block->insert(index_block, ele)) {
-                    ++num_block;
-                    if (block == tail_block) tail_block = block->nxt_block;
-                }
+                index_add(block, 1);
+                if (block == tail_block) ++block->epoch;
+                else ++epoch;
             }
             ++size_deque;
-            block = getBlock(pos.ind_deque, index_block);
-            pos.ele = ele;
-            pos.block = block;
-            pos.ind_block = index_block;
+            adapt();
+            locate(pos);
             return pos;
         }
 
@@ -797,26 +1420,130 @@ namespace sjtu {
             Block *block = getBlock(pos.ind_deque, index_block);
             bool flag = (block == tail_block), flag_ = (block->nxt_block == tail_block);
             Block *pre_block = block->pre_block;
-            int merge_ = block->erase(index_block);
+            int merge_ = block->erase(this, index_block);
             if (merge_) {
                 --num_block;
                 if (merge_ == 1 && flag_) tail_block = block;
                 if (merge_ == 2 && flag) tail_block = pre_block;
+                ++epoch;
+            } else {
+                index_add(block, -1);
+                if (flag) ++block->epoch;
+                else ++epoch;
             }
             --size_deque;
+            adapt();
             if (pos.ind_deque == size_deque) return end();
-            Element *ele = getElement(pos.ind_deque, block, index_block);
-            pos.ind_block = index_block;
-            pos.block = block;
-            pos.ele = ele;
+            locate(pos);
             return pos;
         }
 
+        /**
+         * inserts n copies of value before pos: they are built into packed blocks of their own first,
+         *   which are then spliced in, so pos is located once and only its block is cut.
+         * returns an iterator pointing to the first inserted element (or pos if n == 0).
+         */
+        iterator insert(iterator pos, size_t n, const T &value) {
+            if (pos.origin != this || !pos.isValid()) throw invalid_iterator();
+            deque run(alloc, block_size);
+            for (; n > 0; --n) run.push_back(value);
+            int index = pos.ind_deque;
+            splice(pos, run);
+            return iterator(index, this);
+        }
+
+        /**
+         * inserts the elements of [first, last) before pos, as insert(pos, n, value) does.
+         * the range is read in full before this deque changes, so it may point into it.
+         * returns an iterator pointing to the first inserted element (or pos if the range is empty).
+         */
+        template<class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        iterator insert(iterator pos, InputIt first, InputIt last) {
+            if (pos.origin != this || !pos.isValid()) throw invalid_iterator();
+            deque run(alloc, block_size);
+            for (; first != last; ++first) run.push_back(*first);
+            int index = pos.ind_deque;
+            splice(pos, run);
+            return iterator(index, this);
+        }
+
+        /**
+         * removes the elements in [first, last): the blocks inside the range are freed whole, the two
+         *   blocks at its ends are trimmed, and only they are merged with their neighbours. O(sqrt(n) + k).
+         * returns an iterator pointing to the element that followed the range.
+         * throw if either iterator is invalid or points to another deque, or first is after last.
+         */
+        iterator erase(iterator first, iterator last) {
+            if (first.origin != this || last.origin != this || !first.isValid() || !last.isValid()) {
+                throw invalid_iterator();
+            }
+            if (first.ind_deque > last.ind_deque) throw invalid_iterator();
+            int index = first.ind_deque;
+            if (first.ind_deque == last.ind_deque) return iterator(index, this);
+            int index_first, index_last;
+            Block *block_first = getBlock(first.ind_deque, index_first);
+            Block *block_last = getBlock(last.ind_deque, index_last);
+            if (block_first == block_last) {
+                block_first->erase(index_first, index_last);
+                size_deque -= index_last - index_first;
+            } else {
+                while (block_first->nxt_block != block_last) unlink(block_first->nxt_block);
+                size_deque -= block_first->size_block - index_first + index_last;
+                block_first->erase(index_first, block_first->size_block);
+                block_last->erase(0, index_last);
+            }
+            if (block_last != block_first) {
+                if (!block_last->size_block && block_last->pre_block) unlink(block_last);
+                else mend(block_last);
+            }
+            Block *left = block_first;
+            if (!block_first->size_block && (block_first->pre_block || block_first->nxt_block)) {
+                left = block_first->pre_block;
+                unlink(block_first);
+            }
+            mend(left);
+            if (left) mend(left->pre_block);
+            ++epoch;
+            index_valid = false;
+            retune();
+            return iterator(index, this);
+        }
+
         /**
          * adds an element to the end
          */
         void push_back(const T &value) {
-            insert(end(), value);
+            emplace_back(value);
+        }
+
+        void push_back(T &&value) {
+            emplace_back(std::move(value));
+        }
+
+        /**
+         * constructs an element from args at the end.
+         * returns a reference to the new element.
+         */
+        template<class... Args>
+        T &emplace_back(Args &&... args) {
+            if (!head_block) init();
+            Block *block = tail_block;
+            bool fresh = block->size_block == block->capacity;
+            if (fresh) block = end_block();
+            construct(block, block->slot(block->size_block), fresh, std::forward<Args>(args)...);
+            if (fresh) {
+                block->pre_block = tail_block;
+                tail_block->nxt_block = block;
+                ++tail_block->epoch;//the end position moves off the old tail
+                tail_block = block;
+                ++num_block;
+                index_valid = false;
+            }
+            ++block->size_block;
+            ++size_deque;
+            index_add(block, 1);
+            adapt();
+            return tail_block->at(tail_block->size_block - 1);
         }
 
         /**
@@ -825,14 +1552,57 @@ namespace sjtu {
          */
         void pop_back() {
             if (!size_deque) throw container_is_empty();
-            erase(end() - 1);
+            Block *block = tail_block;
+            block->slot(block->size_block - 1)->~T();
+            --block->size_block;
+            --size_deque;
+            if (!block->size_block && block->pre_block) {
+                // no other tree entry covers the tail, so dropping it leaves the index valid
+                tail_block = block->pre_block;
+                tail_block->nxt_block = nullptr;
+                retire(block);
+            } else {
+                index_add(block, -1);
+            }
+            adapt();
         }
 
         /**
          * inserts an element to the beginning.
          */
         void push_front(const T &value) {
-            insert(iterator(0, this), value);
+            emplace_front(value);
+        }
+
+        void push_front(T &&value) {
+            emplace_front(std::move(value));
+        }
+
+        /**
+         * constructs an element from args at the beginning.
+         * returns a reference to the new element.
+         */
+        template<class... Args>
+        T &emplace_front(Args &&... args) {
+            if (!head_block) init();
+            Block *block = head_block;
+            bool fresh = block->size_block == block->capacity;
+            if (fresh) block = end_block();
+            int head = block->head ? block->head - 1 : block->capacity - 1;
+            construct(block, block->buf + head, fresh, std::forward<Args>(args)...);
+            if (fresh) {
+                block->nxt_block = head_block;
+                head_block->pre_block = block;
+                head_block = block;
+                ++num_block;
+                index_valid = false;
+            }
+            block->head = head;
+            ++block->size_block;
+            ++size_deque;
+            ++epoch;
+            adapt();
+            return head_block->at(0);
         }
 
         /**
@@ -843,7 +1613,133 @@ namespace sjtu {
             if (!size_deque) {
                 throw container_is_empty();
             }
-            erase(begin());
+            Block *block = head_block;
+            block->slot(0)->~T();
+            block->head = block->head + 1 == block->capacity ? 0 : block->head + 1;
+            --block->size_block;
+            --size_deque;
+            ++epoch;
+            if (!block->size_block && block->nxt_block) {
+                head_block = block->nxt_block;
+                head_block->pre_block = nullptr;
+                retire(block);
+                index_valid = false;
+            }
+            adapt();
+        }
+
+        /**
+         * moves every element of other in front of pos in O(number of blocks): the blocks of other are
+         *   linked in whole and only the block holding pos is cut in two. small blocks at the seams are
+         *   merged with their neighbours. other is left empty.
+         * if the allocators of the two deques differ, the elements are copied one by one instead.
+         * throw if pos is invalid or points to another deque, or other is this deque.
+         * every iterator of both deques is invalidated.
+         */
+        void splice(iterator pos, deque &other) {
+            if (pos.origin != this || !pos.isValid()) throw invalid_iterator();
+            if (&other == this) throw runtime_error();
+            if (!other.size_deque) return;
+            if (!(alloc == other.alloc)) {
+                insert(pos, other.cbegin(), other.cend());
+                other.clear();
+                return;
+            }
+            Block *left, *right;
+            if (!size_deque) {
+                drop_spare();
+                while (head_block) {
+                    Block *nxt = head_block->nxt_block;
+                    delete_block(head_block);
+                    head_block = nxt;
+                }
+                tail_block = nullptr;
+                num_block = 0;
+                left = right = nullptr;
+            } else {
+                int index_block;
+                Block *block = getBlock(pos.ind_deque, index_block);
+                if (!index_block) {
+                    left = block->pre_block;
+                    right = block;
+                } else if (index_block == block->size_block) {
+                    left = block;
+                    right = block->nxt_block;
+                } else {
+                    right = block->cut(this, index_block);
+                    left = block;
+                    ++num_block;
+                    ++epoch;
+                    if (block == tail_block) tail_block = right;
+                }
+            }
+            adopt(other, other.head_block, left, right);
+            other.head_block = other.tail_block = nullptr;
+            other.clear();
+            retune();
+        }
+
+        /**
+         * appends every element of other, as splice(end(), other).
+         */
+        void concat(deque &other) {
+            splice(end(), other);
+        }
+
+        /**
+         * moves the elements from index on into a new deque and returns it, cutting only the block
+         *   holding index; O(number of blocks).
+         * throw index_out_of_bound if index > size(). every iterator is invalidated.
+         */
+        deque split_at(const size_t &index) {
+            if (index > size_t(size_deque)) throw index_out_of_bound();
+            deque rest(alloc);
+            if (index == size_t(size_deque)) return rest;
+            int index_block;
+            Block *block = getBlock(index, index_block);
+            if (index_block) {
+                Block *right = block->cut(this, index_block);
+                ++num_block;
+                if (block == tail_block) tail_block = right;
+                block = right;
+            }
+            Block *left = block->pre_block;
+            rest.delete_block(rest.head_block);
+            rest.head_block = rest.tail_block = nullptr;
+            rest.num_block = 0;
+            size_deque -= rest.adopt(*this, block, nullptr, nullptr);
+            tail_block = left;
+            if (left) left->nxt_block = nullptr;
+            else head_block = nullptr;
+            num_block = 0;
+            for (Block *b = head_block; b; b = b->nxt_block) ++num_block;
+            index_valid = false;
+            ++epoch;
+            retune();
+            rest.retune();
+            return rest;
+        }
+
+        /**
+         * repacks every element into full blocks in one O(n) pass and frees the surplus blocks,
+         *   e.g. after a burst of middle erases has left many blocks partly empty.
+         * if allocating the new blocks throws, the deque is left as it was. every iterator is invalidated.
+         */
+        void compact() {
+            if (!head_block) return;
+            repack(block_size);
+        }
+
+        /**
+         * turns automatic compaction on: after an operation that leaves more than factor times the blocks
+         *   a packed deque of the same size would have (that is, more than factor * (size() / block size + 1),
+         *   on the order of factor * sqrt(size())), the deque compacts itself. 0 turns it off, the default.
+         * with factor >= 2 a compaction is paid for by the operations that made the blocks sparse,
+         *   so the cost stays O(1) amortized.
+         */
+        void auto_compact(const size_t &factor) {
+            compact_factor = factor;
+            if (head_block && sparse()) repack(block_size);
         }
 
         void display() {
@@ -857,6 +1753,928 @@ namespace sjtu {
 
     };
 
+    /**
+     * the tiered vector engine: the elements sit in tiers, ring buffers of tier_size slots (a power of two),
+     *   listed in order by a directory that is itself a ring, so tiers come and go at both ends in O(1).
+     * every tier is full except the first and the last: with the first element at offset start of the
+     *   first tier, the i-th element is at offset (start + i) % tier_size of tier (start + i) / tier_size,
+     *   and operator[] is two array lookups, O(1).
+     * an insert or erase in the middle shifts the shorter part of one tier by a slot, O(tier_size),
+     *   then hands one element across each tier boundary on the shorter side of the deque, rotating the
+     *   full tiers in between in O(1) each: O(tier_size + n / tier_size) in all.
+     * with BLOCK_SIZE == 0 tier_size follows the same curve as block_size in the block list engine,
+     *   about sqrt(n) scaled up for cheap elements, and every element is moved into tiers of the new size
+     *   in one O(n) pass when it changes. a nonzero BLOCK_SIZE, a power of two, pins it.
+     * iterators hold a position and are O(1) to move and dereference. as in the block list engine,
+     *   any insert or erase, at the ends included, invalidates them, but here stale iterators are not
+     *   detected: isValid() only checks that the position is within [0, size()], so an iterator kept
+     *   across a change refers to whichever element now sits at its position.
+     * the block-level operations of the block list engine (splice, concat, split_at, compact) are not offered.
+     */
+    template<class T, class Alloc, size_t BLOCK_SIZE>
+    class deque<T, Alloc, BLOCK_SIZE, tiered> {
+        static_assert((BLOCK_SIZE & (BLOCK_SIZE - 1)) == 0, "the tier size must be a power of two");
+
+    private:
+        static const int MIN_TIER_SIZE = 64;
+        static const int MAX_TIER_SIZE = 1 << 14;
+        static const size_t TIER_FACTOR = std::is_trivially_copyable<T>::value && sizeof(T) < 16384 ?
+                                          16384 / sizeof(T) : 1;
+
+        /**
+         * offset j of a tier lives at buf[(head + j) & mask].
+         */
+        struct Tier {
+            T *buf;
+            int head;
+        };
+
+        typedef std::allocator_traits<Alloc> alloc_traits;
+        typedef typename alloc_traits::template rebind_alloc<Tier> tier_allocator;
+
+        Alloc alloc;
+
+        /**
+         * the directory: num_tier tiers at dir[dir_head], dir[dir_head + 1], ... (mod dir_capacity,
+         *   a power of two). an empty deque has no tiers and start == 0.
+         */
+        Tier *dir;
+        int dir_capacity, dir_head, num_tier;
+        int start, size_deque;
+
+        /**
+         * tier_size == 1 << shift == mask + 1, and the sizes at which it is adapted next.
+         */
+        int tier_size, shift, mask;
+        size_t grow_at, shrink_at;
+
+        /**
+         * the buffer of the last tier drained at either end, kept for the next tier needed.
+         */
+        T *spare;
+
+        Tier &tier(const int &t) const {
+            return dir[(dir_head + t) & (dir_capacity - 1)];
+        }
+
+        T *slot(const Tier &tr, const int &offset) const {
+            return tr.buf + ((tr.head + offset) & mask);
+        }
+
+        /**
+         * the slot of the element at index.
+         */
+        T *locate(const int &index) const {
+            int pos = start + index;
+            const Tier &tr = tier(pos >> shift);
+            return tr.buf + ((tr.head + pos) & mask);
+        }
+
+        static void move_slots(T *src, int n, T *dst) {
+            move_slots(src, n, dst, std::is_trivially_copyable<T>());
+        }
+
+        static void move_slots(T *src, int n, T *dst, std::true_type) {
+            std::memmove(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(T));
+        }
+
+        static void move_slots(T *src, int n, T *dst, std::false_type) {
+            if (dst < src) {
+                for (int i = 0; i < n; ++i) {
+                    new(dst + i) T(std::move(src[i]));
+                    src[i].~T();
+                }
+            } else {
+                for (int i = n - 1; i >= 0; --i) {
+                    new(dst + i) T(std::move(src[i]));
+                    src[i].~T();
+                }
+            }
+        }
+
+        /**
+         * moves the elements at offsets [first, last) of tr up by one; offset last must be raw,
+         *   and offset first is left raw.
+         */
+        void shift_up(const Tier &tr, int first, int last) const {
+            int n = last - first;
+            while (n > 0) {
+                T *s_end = slot(tr, first + n - 1) + 1, *d_end = slot(tr, first + n) + 1;
+                int len = n;
+                if (s_end - tr.buf < len) len = s_end - tr.buf;
+                if (d_end - tr.buf < len) len = d_end - tr.buf;
+                move_slots(s_end - len, len, d_end - len);
+                n -= len;
+            }
+        }
+
+        /**
+         * moves the elements at offsets [first, last) of tr down by one; offset first - 1 must be raw,
+         *   and offset last - 1 is left raw.
+         */
+        void shift_down(const Tier &tr, int first, int last) const {
+            int n = last - first;
+            while (n > 0) {
+                T *s = slot(tr, first), *d = slot(tr, first - 1);
+                int len = n;
+                if (tr.buf + tier_size - s < len) len = tr.buf + tier_size - s;
+                if (tr.buf + tier_size - d < len) len = tr.buf + tier_size - d;
+                move_slots(s, len, d);
+                first += len;
+                n -= len;
+            }
+        }
+
+        T *new_buffer() {
+            T *buf = spare;
+            spare = nullptr;
+            return buf ? buf : alloc_traits::allocate(alloc, tier_size);
+        }
+
+        void drop_spare() {
+            if (spare) alloc_traits::deallocate(alloc, spare, tier_size);
+            spare = nullptr;
+        }
+
+        void free_dir() {
+            if (!dir) return;
+            tier_allocator tier_alloc(alloc);
+            std::allocator_traits<tier_allocator>::deallocate(tier_alloc, dir, dir_capacity);
+            dir = nullptr;
+            dir_capacity = 0;
+            dir_head = 0;
+        }
+
+        /**
+         * makes room in the directory for one more tier, doubling it when full.
+         */
+        void reserve_tier() {
+            if (num_tier < dir_capacity) return;
+            int capacity = dir_capacity ? dir_capacity * 2 : 4;
+            tier_allocator tier_alloc(alloc);
+            Tier *fresh = std::allocator_traits<tier_allocator>::allocate(tier_alloc, capacity);
+            for (int t = 0; t < num_tier; ++t) fresh[t] = tier(t);
+            free_dir();
+            dir = fresh;
+            dir_capacity = capacity;
+        }
+
+        void push_tier_back() {
+            reserve_tier();
+            Tier &tr = dir[(dir_head + num_tier) & (dir_capacity - 1)];
+            tr.buf = new_buffer();
+            tr.head = 0;
+            ++num_tier;
+        }
+
+        void push_tier_front() {
+            reserve_tier();
+            T *buf = new_buffer();
+            dir_head = (dir_head - 1) & (dir_capacity - 1);
+            dir[dir_head].buf = buf;
+            dir[dir_head].head = 0;
+            ++num_tier;
+        }
+
+        /**
+         * the buffer of a drained tier becomes the spare; the previous spare is freed.
+         */
+        void pop_tier_back() {
+            --num_tier;
+            drop_spare();
+            spare = tier(num_tier).buf;
+        }
+
+        void pop_tier_front() {
+            drop_spare();
+            spare = dir[dir_head].buf;
+            dir_head = (dir_head + 1) & (dir_capacity - 1);
+            --num_tier;
+        }
+
+        /**
+         * drops the tiers left without elements at either end.
+         */
+        void trim() {
+            if (!size_deque) {
+                while (num_tier) pop_tier_back();
+                start = 0;
+                return;
+            }
+            while (start >= tier_size) {
+                pop_tier_front();
+                start -= tier_size;
+            }
+            while (num_tier > ((start + size_deque - 1) >> shift) + 1) pop_tier_back();
+        }
+
+        /**
+         * frees every tier buffer, without destroying the elements in them.
+         */
+        void free_tiers() {
+            for (int t = 0; t < num_tier; ++t) alloc_traits::deallocate(alloc, tier(t).buf, tier_size);
+            num_tier = 0;
+            drop_spare();
+        }
+
+        /**
+         * opens a raw slot at index, 0 < index < size(), by moving the shorter side of the deque out by one,
+         *   and returns it.
+         */
+        T *open(const int &index) {
+            if (index >= size_deque - index) {
+                if (!((start + size_deque) & mask)) push_tier_back();
+                int pos = start + index, t = pos >> shift, last = num_tier - 1;
+                for (int u = last; u > t; --u) {
+                    // offset tier_size - 1 of tier u is raw: rotate it to the front and fill it from tier u - 1
+                    Tier &dst = tier(u);
+                    dst.head = (dst.head - 1) & mask;
+                    move_slots(slot(tier(u - 1), mask), 1, slot(dst, 0));
+                }
+                shift_up(tier(t), pos & mask, t < last ? mask : (start + size_deque) & mask);
+            } else {
+                if (!start) {
+                    push_tier_front();
+                    start = tier_size;
+                }
+                int pos = start + index - 1, t = pos >> shift;
+                for (int u = 0; u < t; ++u) {
+                    Tier &dst = tier(u);
+                    dst.head = (dst.head + 1) & mask;
+                    move_slots(slot(tier(u + 1), 0), 1, slot(dst, mask));
+                }
+                shift_down(tier(t), t ? 1 : start, (pos & mask) + 1);
+                --start;
+            }
+            ++size_deque;
+            return locate(index);
+        }
+
+        /**
+         * the inverse of open: the slot at index is raw and is closed up from the shorter side.
+         */
+        void close(const int &index) {
+            int pos = start + index, t = pos >> shift;
+            if (index >= size_deque - 1 - index) {
+                int last = num_tier - 1;
+                if (t == last) {
+                    shift_down(tier(t), (pos & mask) + 1, ((start + size_deque - 1) & mask) + 1);
+                } else {
+                    shift_down(tier(t), (pos & mask) + 1, tier_size);
+                    for (int u = t + 1; u <= last; ++u) {
+                        Tier &src = tier(u);
+                        move_slots(slot(src, 0), 1, slot(tier(u - 1), mask));
+                        src.head = (src.head + 1) & mask;
+                    }
+                }
+            } else {
+                if (t) {
+                    shift_up(tier(t), 0, pos & mask);
+                    for (int u = t - 1; u >= 0; --u) {
+                        Tier &src = tier(u);
+                        move_slots(slot(src, mask), 1, slot(tier(u + 1), 0));
+                        src.head = (src.head - 1) & mask;
+                    }
+                } else {
+                    shift_up(tier(0), start, pos & mask);
+                }
+                ++start;
+            }
+            --size_deque;
+            trim();
+        }
+
+        static int initial_tier_size() {
+            return BLOCK_SIZE ? int(BLOCK_SIZE) : MIN_TIER_SIZE;
+        }
+
+        /**
+         * the smallest power of two at least MIN_TIER_SIZE with 32 * size * size >= TIER_FACTOR * n,
+         *   capped at MAX_TIER_SIZE.
+         */
+        static int ideal_tier_size(size_t n) {
+            size_t size = MIN_TIER_SIZE;
+            while (size < MAX_TIER_SIZE && 32 * size * size < TIER_FACTOR * n) size *= 2;
+            return int(size);
+        }
+
+        void set_tier_size(int size) {
+            tier_size = size;
+            mask = size - 1;
+            for (shift = 0; (1 << shift) < size; ++shift);
+            if (BLOCK_SIZE) {
+                grow_at = size_t(-1);
+                shrink_at = 0;
+                return;
+            }
+            grow_at = size < MAX_TIER_SIZE ? 64 * size_t(size) * size / TIER_FACTOR : size_t(-1);
+            shrink_at = size > MIN_TIER_SIZE ? 4 * size_t(size) * size / TIER_FACTOR : 0;
+        }
+
+        /**
+         * called after every change of size: once the size has left [shrink_at, grow_at],
+         *   every element is moved into tiers of the new size.
+         */
+        void adapt() {
+            if (size_t(size_deque) > grow_at || size_t(size_deque) < shrink_at) {
+                int size = ideal_tier_size(size_deque);
+                if (size != tier_size) {
+                    retier(size);
+                    return;
+                }
+                set_tier_size(size);
+            }
+        }
+
+        /**
+         * moves every element into full tiers of the given size, O(n). the new tiers are allocated up front,
+         *   so if that throws nothing has changed.
+         */
+        void retier(int size) {
+            deque packed(alloc, size);
+            while (packed.num_tier < (size_deque + size - 1) / size) packed.push_tier_back();
+            for (int i = 0; i < size_deque; ++i) move_slots(locate(i), 1, packed.locate(i));
+            packed.size_deque = size_deque;
+            size_deque = 0;
+            free_tiers();
+            start = 0;
+            swap(packed);
+            set_tier_size(size);
+        }
+
+        /**
+         * an empty deque with its tier size pinned to size, for building a run of elements.
+         */
+        deque(const Alloc &alloc, int size) : alloc(alloc), dir(nullptr), dir_capacity(0), dir_head(0),
+                                              num_tier(0), start(0), size_deque(0), spare(nullptr) {
+            set_tier_size(size);
+            grow_at = size_t(-1);
+            shrink_at = 0;
+        }
+
+        /**
+         * lays the elements of other out at the same offsets; on a throw this deque is left empty.
+         */
+        void copy_tiers(const deque &other) {
+            try {
+                while (num_tier < other.num_tier) push_tier_back();
+                start = other.start;
+                for (; size_deque < other.size_deque; ++size_deque) {
+                    new(locate(size_deque)) T(*other.locate(size_deque));
+                }
+            } catch (...) {
+                clear();
+                throw;
+            }
+        }
+
+        /**
+         * moves the elements of run in before index: one at a time while that shifts fewer elements
+         *   than moving everything once into a fresh layout would, and in one O(n + k) pass otherwise.
+         */
+        void take(const int &index, deque &run) {
+            int k = run.size_deque;
+            if (size_t(k) * (tier_size + num_tier) <= size_t(size_deque) + k) {
+                for (int i = 0; i < k; ++i) emplace(iterator(index + i, this), std::move(*run.locate(i)));
+                return;
+            }
+            deque merged(alloc, ideal_tier_size(size_deque + k));
+            for (int i = 0; i < index; ++i) merged.emplace_back(std::move(*locate(i)));
+            for (int i = 0; i < k; ++i) merged.emplace_back(std::move(*run.locate(i)));
+            for (int i = index; i < size_deque; ++i) merged.emplace_back(std::move(*locate(i)));
+            int size = merged.tier_size;
+            clear();
+            swap(merged);
+            set_tier_size(size);
+        }
+
+    public:
+        class const_iterator;
+
+        class iterator {
+            friend class deque;
+
+        private:
+            deque *origin;
+            int ind_deque;
+
+        public:
+            iterator() : origin(nullptr), ind_deque(0) {}
+
+            iterator(const iterator &iter) : origin(iter.origin), ind_deque(iter.ind_deque) {}
+
+            iterator(int index_deque, deque *deq) : origin(deq), ind_deque(index_deque) {
+                if (index_deque > origin->size_deque)
+                    throw invalid_iterator();
+            }
+
+            /**
+             * a bounds check only; see the class comment.
+             */
+            bool isValid() const {
+                return origin && ind_deque >= 0 && ind_deque <= origin->size_deque;
+            }
+
+            iterator operator+(const int &n) const {
+                iterator iter = *this;
+                iter += n;
+                return iter;
+            }
+
+            iterator operator-(const int &n) const {
+                iterator iter = *this;
+                iter -= n;
+                return iter;
+            }
+
+            int operator-(const iterator &rhs) const {
+                if (origin != rhs.origin) throw invalid_iterator();
+                return ind_deque - rhs.ind_deque;
+            }
+
+            int operator-(const const_iterator &rhs) const {
+                if (origin != rhs.origin) throw invalid_iterator();
+                return ind_deque - rhs.ind_deque;
+            }
+
+            iterator &operator+=(const int &n) {
+                if (ind_deque + n > origin->size_deque || ind_deque + n < 0) throw invalid_iterator();
+                ind_deque += n;
+                return *this;
+            }
+
+            iterator &operator-=(const int &n) {
+                return *this += -n;
+            }
+
+            iterator operator++(int) {
+                iterator tmp = *this;
+                *this += 1;
+                return tmp;
+            }
+
+            iterator &operator++() {
+                *this += 1;
+                return *this;
+            }
+
+            iterator operator--(int) {
+                iterator tmp = *this;
+                *this -= 1;
+                return tmp;
+            }
+
+            iterator &operator--() {
+                *this -= 1;
+                return *this;
+            }
+
+            T &operator*() const {
+                if (!origin || ind_deque < 0 || ind_deque >= origin->size_deque) throw invalid_iterator();
+                return *origin->locate(ind_deque);
+            }
+
+            T *operator->() const {
+                return &**this;
+            }
+
+            bool operator==(const iterator &rhs) const {
+                return origin == rhs.origin && ind_deque == rhs.ind_deque;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                return origin == rhs.origin && ind_deque == rhs.ind_deque;
+            }
+
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+
+        class const_iterator {
+            friend class deque;
+
+        private:
+            const deque *origin;
+            int ind_deque;
+
+        public:
+            const_iterator() : origin(nullptr), ind_deque(0) {}
+
+            const_iterator(const const_iterator &other) : origin(other.origin), ind_deque(other.ind_deque) {}
+
+            const_iterator(const iterator &other) : origin(other.origin), ind_deque(other.ind_deque) {}
+
+            const_iterator(int index_deque, const deque *deq) : origin(deq), ind_deque(index_deque) {
+                if (index_deque > origin->size_deque)
+                    throw invalid_iterator();
+            }
+
+            bool isValid() const {
+                return origin && ind_deque >= 0 && ind_deque <= origin->size_deque;
+            }
+
+            const_iterator operator+(const int &n) const {
+                const_iterator iter = *this;
+                iter += n;
+                return iter;
+            }
+
+            const_iterator operator-(const int &n) const {
+                const_iterator iter = *this;
+                iter -= n;
+                return iter;
+            }
+
+            int operator-(const const_iterator &rhs) const {
+                if (origin != rhs.origin) throw invalid_iterator();
+                return ind_deque - rhs.ind_deque;
+            }
+
+            int operator-(const iterator &rhs) const {
+                if (origin != rhs.origin) throw invalid_iterator();
+                return ind_deque - rhs.ind_deque;
+            }
+
+            const_iterator &operator+=(const int &n) {
+                if (ind_deque + n > origin->size_deque || ind_deque + n < 0) throw invalid_iterator();
+                ind_deque += n;
+                return *this;
+            }
+
+            const_iterator &operator-=(const int &n) {
+                return *this += -n;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                *this += 1;
+                return tmp;
+            }
+
+            const_iterator &operator++() {
+                *this += 1;
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                const_iterator tmp = *this;
+                *this -= 1;
+                return tmp;
+            }
+
+            const_iterator &operator--() {
+                *this -= 1;
+                return *this;
+            }
+
+            const T &operator*() const {
+                if (!origin || ind_deque < 0 || ind_deque >= origin->size_deque) throw invalid_iterator();
+                return *origin->locate(ind_deque);
+            }
+
+            const T *operator->() const {
+                return &**this;
+            }
+
+            bool operator==(const iterator &rhs) const {
+                return origin == rhs.origin && ind_deque == rhs.ind_deque;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                return origin == rhs.origin && ind_deque == rhs.ind_deque;
+            }
+
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+
+        deque() : alloc(), dir(nullptr), dir_capacity(0), dir_head(0), num_tier(0), start(0), size_deque(0),
+                  spare(nullptr) {
+            set_tier_size(initial_tier_size());
+        }
+
+        explicit deque(const Alloc &alloc) : alloc(alloc), dir(nullptr), dir_capacity(0), dir_head(0), num_tier(0),
+                                             start(0), size_deque(0), spare(nullptr) {
+            set_tier_size(initial_tier_size());
+        }
+
+        deque(const deque &other) : alloc(other.alloc), dir(nullptr), dir_capacity(0), dir_head(0), num_tier(0),
+                                    start(0), size_deque(0), spare(nullptr) {
+            set_tier_size(other.tier_size);
+            copy_tiers(other);
+        }
+
+        deque(deque &&other) noexcept : alloc(other.alloc), dir(nullptr), dir_capacity(0), dir_head(0),
+                                        num_tier(0), start(0), size_deque(0), spare(nullptr) {
+            set_tier_size(initial_tier_size());
+            swap(other);
+        }
+
+        ~deque() {
+            clear();
+        }
+
+        deque &operator=(const deque &other) {
+            if (this == &other) return *this;
+            clear();
+            set_tier_size(other.tier_size);
+            copy_tiers(other);
+            return *this;
+        }
+
+        deque &operator=(deque &&other) noexcept {
+            if (this == &other) return *this;
+            deque tmp(std::move(other));
+            swap(tmp);
+            return *this;
+        }
+
+        void swap(deque &other) noexcept {
+            std::swap(alloc, other.alloc);
+            std::swap(dir, other.dir);
+            std::swap(dir_capacity, other.dir_capacity);
+            std::swap(dir_head, other.dir_head);
+            std::swap(num_tier, other.num_tier);
+            std::swap(start, other.start);
+            std::swap(size_deque, other.size_deque);
+            std::swap(tier_size, other.tier_size);
+            std::swap(shift, other.shift);
+            std::swap(mask, other.mask);
+            std::swap(grow_at, other.grow_at);
+            std::swap(shrink_at, other.shrink_at);
+            std::swap(spare, other.spare);
+        }
+
+        void clear() {
+            if (!std::is_trivially_destructible<T>::value) {
+                for (int i = 0; i < size_deque; ++i) locate(i)->~T();
+            }
+            free_tiers();
+            free_dir();
+            start = size_deque = 0;
+            set_tier_size(initial_tier_size());
+        }
+
+        T &at(const size_t &pos) {
+            if (pos >= size_t(size_deque)) throw index_out_of_bound();
+            return *locate(int(pos));
+        }
+
+        const T &at(const size_t &pos) const {
+            if (pos >= size_t(size_deque)) throw index_out_of_bound();
+            return *locate(int(pos));
+        }
+
+        T &operator[](const size_t &pos) {
+            if (pos >= size_t(size_deque)) throw index_out_of_bound();
+            return *locate(int(pos));
+        }
+
+        const T &operator[](const size_t &pos) const {
+            if (pos >= size_t(size_deque)) throw index_out_of_bound();
+            return *locate(int(pos));
+        }
+
+        /**
+         * writes the elements at the positions in [first, last) to out, O(1) each, as the block list engine does.
+         * throw index_out_of_bound, before anything is written, if a position is not below size().
+         */
+        template<class IndexIt, class OutputIt>
+        OutputIt gather(IndexIt first, IndexIt last, OutputIt out) const {
+            for (IndexIt it = first; it != last; ++it) {
+                if (size_t(*it) >= size_t(size_deque)) throw index_out_of_bound();
+            }
+            for (; first != last; ++first, ++out) *out = *locate(int(*first));
+            return out;
+        }
+
+        const T &front() const {
+            if (!size_deque) throw container_is_empty();
+            return *locate(0);
+        }
+
+        const T &back() const {
+            if (!size_deque) throw container_is_empty();
+            return *locate(size_deque - 1);
+        }
+
+        iterator begin() {
+            return iterator(0, this);
+        }
+
+        const_iterator cbegin() const {
+            if (!size_deque) throw container_is_empty();
+            return const_iterator(0, this);
+        }
+
+        iterator end() {
+            return iterator(size_deque, this);
+        }
+
+        const_iterator cend() const {
+            return const_iterator(size_deque, this);
+        }
+
+        bool empty() const {
+            return !size_deque;
+        }
+
+        size_t size() const {
+            return size_deque;
+        }
+
+        iterator insert(iterator pos, const T &value) {
+            return emplace(pos, value);
+        }
+
+        iterator insert(iterator pos, T &&value) {
+            return emplace(pos, std::move(value));
+        }
+
+        /**
+         * constructs an element from args before pos; args may refer to elements of this deque.
+         * returns an iterator pointing to the new element.
+         */
+        template<class... Args>
+        iterator emplace(iterator pos, Args &&... args) {
+            if (pos.origin != this || !pos.isValid()) throw invalid_iterator();
+            int index = pos.ind_deque;
+            T value(std::forward<Args>(args)...);
+            if (index == size_deque) {
+                emplace_back(std::move(value));
+            } else if (!index) {
+                emplace_front(std::move(value));
+            } else {
+                T *p = open(index);
+                try {
+                    new(p) T(std::move(value));
+                } catch (...) {
+                    close(index);
+                    throw;
+                }
+                adapt();
+            }
+            return iterator(index, this);
+        }
+
+        /**
+         * removes the element at pos.
+         * returns an iterator pointing to the following element, end() if pos pointed to the last one.
+         */
+        iterator erase(iterator pos) {
+            if (pos.origin != this || !pos.isValid()) throw invalid_iterator();
+            int index = pos.ind_deque;
+            if (index >= size_deque) throw index_out_of_bound();
+            if (index == size_deque - 1) {
+                pop_back();
+            } else if (!index) {
+                pop_front();
+            } else {
+                locate(index)->~T();
+                close(index);
+                adapt();
+            }
+            return iterator(index, this);
+        }
+
+        /**
+         * inserts n copies of value before pos.
+         * returns an iterator pointing to the first inserted element (or pos if n == 0).
+         */
+        iterator insert(iterator pos, size_t n, const T &value) {
+            if (pos.origin != this || !pos.isValid()) throw invalid_iterator();
+            deque run(alloc, tier_size);
+            for (; n > 0; --n) run.push_back(value);
+            take(pos.ind_deque, run);
+            return iterator(pos.ind_deque, this);
+        }
+
+        /**
+         * inserts the elements of [first, last) before pos; the range may point into this deque.
+         * returns an iterator pointing to the first inserted element (or pos if the range is empty).
+         */
+        template<class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        iterator insert(iterator pos, InputIt first, InputIt last) {
+            if (pos.origin != this || !pos.isValid()) throw invalid_iterator();
+            deque run(alloc, tier_size);
+            for (; first != last; ++first) run.push_back(*first);
+            take(pos.ind_deque, run);
+            return iterator(pos.ind_deque, this);
+        }
+
+        /**
+         * removes the elements in [first, last) by moving the shorter outside part over them,
+         *   O(min(index, size() - index) + k).
+         * returns an iterator pointing to the element that followed the range.
+         */
+        iterator erase(iterator first, iterator last) {
+            if (first.origin != this || last.origin != this || !first.isValid() || !last.isValid()) {
+                throw invalid_iterator();
+            }
+            if (first.ind_deque > last.ind_deque) throw invalid_iterator();
+            int l = first.ind_deque, r = last.ind_deque, k = r - l;
+            if (!k) return iterator(l, this);
+            if (!std::is_trivially_destructible<T>::value) {
+                for (int i = l; i < r; ++i) locate(i)->~T();
+            }
+            if (l < size_deque - r) {
+                for (int i = l - 1; i >= 0; --i) move_slots(locate(i), 1, locate(i + k));
+                start += k;
+            } else {
+                for (int i = r; i < size_deque; ++i) move_slots(locate(i), 1, locate(i - k));
+            }
+            size_deque -= k;
+            trim();
+            adapt();
+            return iterator(l, this);
+        }
+
+        void push_back(const T &value) {
+            emplace_back(value);
+        }
+
+        void push_back(T &&value) {
+            emplace_back(std::move(value));
+        }
+
+        template<class... Args>
+        T &emplace_back(Args &&... args) {
+            bool fresh = (start + size_deque) >> shift == num_tier;
+            if (fresh) push_tier_back();
+            try {
+                new(locate(size_deque)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                if (fresh) pop_tier_back();
+                throw;
+            }
+            ++size_deque;
+            adapt();
+            return *locate(size_deque - 1);
+        }
+
+        void pop_back() {
+            if (!size_deque) throw container_is_empty();
+            locate(size_deque - 1)->~T();
+            --size_deque;
+            trim();
+            adapt();
+        }
+
+        void push_front(const T &value) {
+            emplace_front(value);
+        }
+
+        void push_front(T &&value) {
+            emplace_front(std::move(value));
+        }
+
+        template<class... Args>
+        T &emplace_front(Args &&... args) {
+            bool fresh = !start;
+            if (fresh) {
+                push_tier_front();
+                start = tier_size;
+            }
+            try {
+                new(locate(-1)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                if (fresh) {
+                    pop_tier_front();
+                    start = 0;
+                }
+                throw;
+            }
+            --start;
+            ++size_deque;
+            adapt();
+            return *locate(0);
+        }
+
+        void pop_front() {
+            if (!size_deque) throw container_is_empty();
+            locate(0)->~T();
+            ++start;
+            --size_deque;
+            trim();
+            adapt();
+        }
+    };
+
+    template<class T, class Alloc, size_t BLOCK_SIZE, class Engine>
+    void swap(deque<T, Alloc, BLOCK_SIZE, Engine> &lhs, deque<T, Alloc, BLOCK_SIZE, Engine> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
 }
 
 #endif
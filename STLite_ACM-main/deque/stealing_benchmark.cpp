@@ -0,0 +1,109 @@
+#include "deque.hpp"
+#include "work_stealing_deque.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * runs a fork-join task tree on W workers, each with a deque of its own: a worker pops tasks from its deque,
+ *   a task of depth d > 0 pushes two tasks of depth d - 1, and a worker whose deque is empty steals from
+ *   a random other one. the same scheduler runs on work_stealing_deque and on sjtu::deque behind a mutex.
+ * the table gives millions of tasks per second for each worker count.
+ */
+const int DEPTH = 21;
+const int WORK = 50;
+
+struct locked_deque {
+    std::mutex lock;
+    sjtu::deque<int> tasks;
+
+    void push(const int &task) {
+        std::lock_guard<std::mutex> guard(lock);
+        tasks.push_back(task);
+    }
+
+    bool pop(int &task) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (tasks.empty()) return false;
+        task = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+
+    bool steal(int &task) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (tasks.empty()) return false;
+        task = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+};
+
+/**
+ * a stand-in for the body of a leaf task.
+ */
+unsigned Work(unsigned seed) {
+    for (int i = 0; i < WORK; ++i) seed = seed * 1103515245u + 12345u;
+    return seed;
+}
+
+template<class Deque>
+double Run(int workers, unsigned &checksum) {
+    std::vector<Deque *> queues;
+    for (int i = 0; i < workers; ++i) queues.push_back(new Deque());
+    const long long total = (1LL << (DEPTH + 1)) - 1;
+    std::atomic<long long> done(0);
+    std::atomic<unsigned> sum(0);
+    queues[0]->push(DEPTH);
+    std::chrono::steady_clock::time_point from = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int w = 0; w < workers; ++w) {
+        threads.push_back(std::thread([&, w]() {
+            Deque &own = *queues[w];
+            unsigned rnd = w * 2654435761u + 1, local_sum = 0;
+            long long local = 0;
+            int task;
+            while (true) {
+                if (own.pop(task) || (workers > 1 && queues[(rnd = rnd * 1664525u + 1013904223u) % workers]->steal(task))) {
+                    if (task) {
+                        own.push(task - 1);
+                        own.push(task - 1);
+                    } else {
+                        local_sum += Work(local);
+                    }
+                    ++local;
+                    continue;
+                }
+                // out of work: publish the count, then stop once every task is accounted for
+                if (local) done.fetch_add(local);
+                local = 0;
+                if (done.load() == total) break;
+                std::this_thread::yield();
+            }
+            sum.fetch_add(local_sum);
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) threads[i].join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - from).count();
+    checksum += sum.load();
+    for (int i = 0; i < workers; ++i) delete queues[i];
+    return total / seconds / 1e6;
+}
+
+int main() {
+    unsigned checksum = 0;
+    printf("%d tasks, %u hardware threads\n", (1 << (DEPTH + 1)) - 1, std::thread::hardware_concurrency());
+    printf("%7s %12s %12s   (million tasks per second)\n", "workers", "lock-free", "mutex");
+    for (int workers = 1; workers <= 8; workers *= 2) {
+        printf("%7d", workers);
+        printf(" %12.2f", Run<sjtu::work_stealing_deque<int>>(workers, checksum));
+        printf(" %12.2f\n", Run<locked_deque>(workers, checksum));
+        fflush(stdout);
+    }
+    printf("checksum %u\n", checksum);
+    return 0;
+}
@@ -0,0 +1,190 @@
+#ifndef SJTU_WORK_STEALING_DEQUE_HPP
+#define SJTU_WORK_STEALING_DEQUE_HPP
+
+#include "allocator.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace sjtu {
+
+    /**
+     * a lock-free work-stealing deque (Chase and Lev, with the memory orders of Le, Pop, Cohen and
+     *   Zappa Nardelli): one owner thread pushes and pops at the bottom, any number of thief threads
+     *   steal from the top. none of them ever blocks.
+     * the elements sit in a ring buffer indexed by two ever-growing counters, top and bottom.
+     *   when a push finds it full, the owner copies the elements into a ring of twice the capacity
+     *   and publishes it; a thief may still be reading the old ring, so it is kept (not freed)
+     *   until the deque is destroyed, which costs at most as much memory again as the largest ring.
+     * elements are copied in and out as whole values and may be read by a thief that then loses the race
+     *   for them, so T must be trivially copyable: a task pointer or an index, typically.
+     * pop and steal report an empty deque (and a thief losing a race) by returning false rather than
+     *   throwing, as both are routine in a scheduler loop.
+     * push and pop may only be called by the owner thread; steal, size and empty by any thread.
+     */
+    template<class T, class Alloc = allocator<T>>
+    class work_stealing_deque {
+        static_assert(std::is_trivially_copyable<T>::value, "work_stealing_deque needs a trivially copyable T");
+
+    private:
+        static const size_t CACHE_LINE = 64;
+
+        struct Ring {
+            long long capacity;//a power of two
+            std::atomic<T> *slots;
+            Ring *retired;//the ring this one replaced
+
+            T get(long long i) const {
+                return slots[i & (capacity - 1)].load(std::memory_order_relaxed);
+            }
+
+            void put(long long i, const T &value) {
+                slots[i & (capacity - 1)].store(value, std::memory_order_relaxed);
+            }
+        };
+
+        typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Ring> ring_allocator;
+        typedef typename std::allocator_traits<Alloc>::template rebind_alloc<std::atomic<T>> slot_allocator;
+
+        /**
+         * top is written by thieves and bottom by the owner, so each gets a cache line of its own.
+         */
+        std::atomic<long long> top;
+        char top_pad[CACHE_LINE - sizeof(std::atomic<long long>)];
+        std::atomic<long long> bottom;
+        char bottom_pad[CACHE_LINE - sizeof(std::atomic<long long>)];
+        std::atomic<Ring *> ring;
+        Alloc alloc;
+
+        Ring *new_ring(long long capacity, Ring *retired) {
+            ring_allocator ring_alloc(alloc);
+            slot_allocator slot_alloc(alloc);
+            Ring *r = std::allocator_traits<ring_allocator>::allocate(ring_alloc, 1);
+            try {
+                r->slots = std::allocator_traits<slot_allocator>::allocate(slot_alloc, capacity);
+            } catch (...) {
+                std::allocator_traits<ring_allocator>::deallocate(ring_alloc, r, 1);
+                throw;
+            }
+            for (long long i = 0; i < capacity; ++i) new(r->slots + i) std::atomic<T>();
+            r->capacity = capacity;
+            r->retired = retired;
+            return r;
+        }
+
+        void delete_ring(Ring *r) {
+            ring_allocator ring_alloc(alloc);
+            slot_allocator slot_alloc(alloc);
+            std::allocator_traits<slot_allocator>::deallocate(slot_alloc, r->slots, r->capacity);
+            std::allocator_traits<ring_allocator>::deallocate(ring_alloc, r, 1);
+        }
+
+        /**
+         * copies [t, b) into a ring of twice the capacity and publishes it. owner only.
+         */
+        Ring *grow(Ring *r, long long t, long long b) {
+            Ring *bigger = new_ring(r->capacity * 2, r);
+            for (long long i = t; i < b; ++i) bigger->put(i, r->get(i));
+            ring.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+
+    public:
+        /**
+         * an empty deque with room for capacity elements (rounded up to a power of two) before it grows.
+         */
+        explicit work_stealing_deque(size_t capacity = 64, const Alloc &alloc = Alloc()) : top(0), bottom(0),
+                                                                                         alloc(alloc) {
+            long long size = 1;
+            while (size < (long long) capacity) size *= 2;
+            ring.store(new_ring(size, nullptr), std::memory_order_relaxed);
+        }
+
+        work_stealing_deque(const work_stealing_deque &) = delete;
+
+        work_stealing_deque &operator=(const work_stealing_deque &) = delete;
+
+        /**
+         * no other thread may be using the deque any more.
+         */
+        ~work_stealing_deque() {
+            Ring *r = ring.load(std::memory_order_relaxed);
+            while (r) {
+                Ring *retired = r->retired;
+                delete_ring(r);
+                r = retired;
+            }
+        }
+
+        /**
+         * adds value at the bottom. owner only.
+         * throws whatever the allocator throws if the ring has to grow; the deque is then unchanged.
+         */
+        void push(const T &value) {
+            long long b = bottom.load(std::memory_order_relaxed);
+            long long t = top.load(std::memory_order_acquire);
+            Ring *r = ring.load(std::memory_order_relaxed);
+            if (b - t > r->capacity - 1) r = grow(r, t, b);
+            r->put(b, value);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        /**
+         * takes the bottom element into value; returns false if the deque is empty
+         *   (or its last element went to a thief). owner only.
+         */
+        bool pop(T &value) {
+            long long b = bottom.load(std::memory_order_relaxed) - 1;
+            Ring *r = ring.load(std::memory_order_relaxed);
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            long long t = top.load(std::memory_order_relaxed);
+            if (t > b) {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            value = r->get(b);
+            if (t == b) {
+                // the last element: race the thieves for it through top
+                bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                       std::memory_order_relaxed);
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        /**
+         * takes the top element into value; returns false if the deque is empty or another thread
+         *   took the element first. any thread.
+         */
+        bool steal(T &value) {
+            long long t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            long long b = bottom.load(std::memory_order_acquire);
+            if (t >= b) return false;
+            Ring *r = ring.load(std::memory_order_acquire);
+            value = r->get(t);
+            return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        /**
+         * the number of elements at some moment during the call; exact only when no other thread is active.
+         */
+        size_t size() const {
+            long long b = bottom.load(std::memory_order_relaxed);
+            long long t = top.load(std::memory_order_relaxed);
+            return b > t ? size_t(b - t) : 0;
+        }
+
+        bool empty() const {
+            return !size();
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include "map.hpp"
+#include "btree_map.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+/**
+ * times the balancing engines of map, and btree_map, phase by phase: n inserts of distinct keys in random order,
+ *   n successful finds in another random order, one full iteration, and n erases in the reverse
+ *   of the insertion order, for n from 10^3 to 10^7.
+ */
+typedef std::vector<int> Keys;
+
+template<class Balance>
+using Tree = sjtu::map<int, int, std::less<int>, sjtu::allocator<sjtu::pair<const int, int>>, Balance>;
+
+double elapsed(clock_t from) {
+    return double(clock() - from) / CLOCKS_PER_SEC;
+}
+
+/**
+ * 0 ... n - 1 shuffled, spread out by an odd factor so that neighbouring keys are not consecutive.
+ */
+Keys shuffled(int n) {
+    Keys keys(n);
+    for (int i = 0; i < n; ++i) keys[i] = int(i * 2654435761u & 0x7fffffff);
+    for (int i = n - 1; i > 0; --i) {
+        int j = int(((long long) rand() * (RAND_MAX + 1ll) + rand()) % (i + 1));
+        int t = keys[i];
+        keys[i] = keys[j];
+        keys[j] = t;
+    }
+    return keys;
+}
+
+template<class Map>
+void Phases(const Keys &keys, const Keys &probes, long long &checksum) {
+    Map m;
+    clock_t from = clock();
+    for (size_t i = 0; i < keys.size(); ++i) m[keys[i]] = int(i);
+    printf(" %7.3f", elapsed(from));
+    from = clock();
+    for (size_t i = 0; i < probes.size(); ++i) checksum += m.find(probes[i])->second;
+    printf(" %7.3f", elapsed(from));
+    from = clock();
+    for (typename Map::iterator it = m.begin(); it != m.end(); ++it) checksum += it->first;
+    printf(" %7.3f", elapsed(from));
+    from = clock();
+    for (size_t i = 0; i < keys.size(); ++i) m.erase(m.find(keys[keys.size() - 1 - i]));
+    printf(" %7.3f", elapsed(from));
+    checksum += m.size();
+}
+
+int main() {
+    long long checksum = 0;
+    printf("%9s %31s   %31s   %31s   %31s\n", "", "treap", "red_black", "avl", "btree_map");
+    printf("%9s", "n");
+    for (int i = 0; i < 4; ++i) printf(" %7s %7s %7s %7s", "insert", "find", "iterate", "erase");
+    printf("   (seconds)\n");
+    for (int n = 1000; n <= 10000000; n *= 10) {
+        srand(n);
+        Keys keys = shuffled(n), probes = shuffled(n);
+        printf("%9d", n);
+        Phases<Tree<sjtu::treap>>(keys, probes, checksum);
+        Phases<Tree<sjtu::red_black>>(keys, probes, checksum);
+        Phases<Tree<sjtu::avl>>(keys, probes, checksum);
+        Phases<sjtu::btree_map<int, int>>(keys, probes, checksum);
+        printf("\n");
+        fflush(stdout);
+    }
+    printf("checksum %lld\n", checksum);
+    return 0;
+}
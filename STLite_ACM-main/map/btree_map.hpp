@@ -0,0 +1,833 @@
+#ifndef SJTU_BTREE_MAP_HPP
+#define SJTU_BTREE_MAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include "utility.hpp"
+#include "exceptions.hpp"
+#include "allocator.hpp"
+
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace sjtu {
+
+    /**
+     * a map kept in a B+ tree, with the interface of map. the elements sit in leaves of up to fanout
+     *   of them, stored side by side and sorted; the leaves are linked in key order, and the inner nodes
+     *   above them hold only separator keys and up to fanout children. a lookup touches about
+     *   log_fanout(n) nodes, each searched in a few cache lines, instead of one node per level of a binary
+     *   tree, and iteration walks the elements of each leaf in order, then steps to the next leaf.
+     * FANOUT == 0 picks fanout from the element size so that a leaf spans about 1KB (from 16 to 256
+     *   elements); a nonzero FANOUT (at least 4) sets it.
+     * unlike map, elements move when their leaf is split, merged or shifted, so insert and erase
+     *   invalidate every iterator of the map. elements are moved by their move constructor (a copy of
+     *   the key), and separator keys are copies of keys; the map relies on neither throwing.
+     * building the new element may throw, as may allocating nodes: both happen before insert changes
+     *   anything, so a throwing insert leaves the map as it was.
+     */
+    template<
+            class Key,
+            class T,
+            class Compare = std::less<Key>,
+            class Alloc = allocator<pair<const Key, T>>,
+            size_t FANOUT = 0
+    >
+    class btree_map {
+    public:
+        typedef pair<const Key, T> value_type;
+
+        static const int fanout = FANOUT ? int(FANOUT) :
+                                  sizeof(value_type) >= 64 ? 16 :
+                                  sizeof(value_type) <= 4 ? 256 : int(1024 / sizeof(value_type));
+
+        static_assert(fanout >= 4, "btree_map needs a fanout of at least 4");
+
+    private:
+        typedef std::allocator_traits<Alloc> alloc_traits;
+
+        /**
+         * the fewest elements of a leaf, and children of an inner node, other than the root.
+         */
+        static const int MIN_COUNT = fanout / 2;
+
+        /**
+         * count is the number of elements of a leaf, or of children of an inner node.
+         */
+        struct Node {
+            bool leaf;
+            int count;
+        };
+
+        struct Leaf : Node {
+            Leaf *prev, *next;
+            typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type slots[fanout];
+
+            value_type &val(int i) {
+                return *reinterpret_cast<value_type *>(slots + i);
+            }
+
+            const Key &key(int i) {
+                return val(i).first;
+            }
+
+            /**
+             * moves the element at from into the empty slot to.
+             */
+            void move(int from, Leaf *to_leaf, int to) {
+                new(to_leaf->slots + to) value_type(std::move(val(from)));
+                val(from).~value_type();
+            }
+        };
+
+        /**
+         * key(i) separates child[i] from child[i + 1]: it is above every key under child[i]
+         *   and at most the lowest key under child[i + 1].
+         * there is room for one child (and key) more than fanout, so that a node can take a new child
+         *   before it is split.
+         */
+        struct Inner : Node {
+            typename std::aligned_storage<sizeof(Key), alignof(Key)>::type keys[fanout];
+            Node *child[fanout + 1];
+
+            Key &key(int i) {
+                return *reinterpret_cast<Key *>(keys + i);
+            }
+
+            void move_key(int from, Inner *to_inner, int to) {
+                new(to_inner->keys + to) Key(std::move(key(from)));
+                key(from).~Key();
+            }
+
+            void set_key(int i, const Key &key_value) {
+                Key copy(key_value);
+                key(i).~Key();
+                new(keys + i) Key(std::move(copy));
+            }
+        };
+
+        Node *root;
+        Leaf *head, *tail;//the first and last leaf
+        size_t num;
+        Compare cmp;
+        Alloc alloc;
+
+        template<class U>
+        U *create() {
+            typename alloc_traits::template rebind_alloc<U> a(alloc);
+            U *p = alloc_traits::template rebind_traits<U>::allocate(a, 1);
+            new(p) U;
+            return p;
+        }
+
+        template<class U>
+        void dispose(U *p) {
+            typename alloc_traits::template rebind_alloc<U> a(alloc);
+            p->~U();
+            alloc_traits::template rebind_traits<U>::deallocate(a, p, 1);
+        }
+
+        Leaf *new_leaf() {
+            Leaf *leaf = create<Leaf>();
+            leaf->leaf = true;
+            leaf->count = 0;
+            leaf->prev = leaf->next = nullptr;
+            return leaf;
+        }
+
+        Inner *new_inner() {
+            Inner *inner = create<Inner>();
+            inner->leaf = false;
+            inner->count = 0;
+            return inner;
+        }
+
+        void clear(Node *node) {
+            if (node->leaf) {
+                Leaf *leaf = static_cast<Leaf *>(node);
+                for (int i = 0; i < leaf->count; ++i) leaf->val(i).~value_type();
+                dispose(leaf);
+            } else {
+                Inner *inner = static_cast<Inner *>(node);
+                for (int i = 0; i < inner->count; ++i) clear(inner->child[i]);
+                for (int i = 0; i + 1 < inner->count; ++i) inner->key(i).~Key();
+                dispose(inner);
+            }
+        }
+
+        /**
+         * copies the subtree at node, appending its leaves to the list ending at tail.
+         */
+        Node *copy(Node *node) {
+            if (node->leaf) {
+                Leaf *from = static_cast<Leaf *>(node), *leaf = new_leaf();
+                for (; leaf->count < from->count; ++leaf->count) {
+                    new(leaf->slots + leaf->count) value_type(from->val(leaf->count));
+                }
+                leaf->prev = tail;
+                if (tail) tail->next = leaf;
+                else head = leaf;
+                tail = leaf;
+                return leaf;
+            }
+            Inner *from = static_cast<Inner *>(node), *inner = new_inner();
+            for (; inner->count < from->count; ++inner->count) {
+                if (inner->count) new(inner->keys + inner->count - 1) Key(from->key(inner->count - 1));
+                inner->child[inner->count] = copy(from->child[inner->count]);
+            }
+            return inner;
+        }
+
+        void copy_from(const btree_map &other) {
+            root = nullptr;
+            head = tail = nullptr;
+            num = 0;
+            if (other.root) root = copy(other.root);
+            num = other.num;
+        }
+
+        /**
+         * the first element of leaf whose key is not below key, or leaf->count.
+         */
+        int lower(Leaf *leaf, const Key &key) const {
+            int l = 0, r = leaf->count;
+            while (l < r) {
+                int mid = (l + r) >> 1;
+                if (cmp(leaf->key(mid), key)) l = mid + 1;
+                else r = mid;
+            }
+            return l;
+        }
+
+        /**
+         * the child of inner whose subtree key belongs to.
+         */
+        int route(Inner *inner, const Key &key) const {
+            int l = 0, r = inner->count - 1;
+            while (l < r) {
+                int mid = (l + r) >> 1;
+                if (cmp(key, inner->key(mid))) r = mid;
+                else l = mid + 1;
+            }
+            return l;
+        }
+
+        Leaf *leaf_of(const Key &key) const {
+            Node *node = root;
+            while (!node->leaf) {
+                Inner *inner = static_cast<Inner *>(node);
+                node = inner->child[route(inner, key)];
+            }
+            return static_cast<Leaf *>(node);
+        }
+
+        static const Key &lowest(Node *node) {
+            while (!node->leaf) node = static_cast<Inner *>(node)->child[0];
+            return static_cast<Leaf *>(node)->key(0);
+        }
+
+        /**
+         * puts a new element built from val at index i of leaf, which has room for it.
+         */
+        template<class V>
+        void put(Leaf *leaf, int i, V &&val) {
+            for (int j = leaf->count; j > i; --j) leaf->move(j - 1, leaf, j);
+            try {
+                new(leaf->slots + i) value_type(std::forward<V>(val));
+            } catch (...) {
+                for (int j = i; j < leaf->count; ++j) leaf->move(j + 1, leaf, j);
+                throw;
+            }
+            ++leaf->count;
+        }
+
+        /**
+         * allocates the n inner nodes a leaf split is going to take, linked through child[0],
+         *   before the split starts; if one allocation fails, the others are given back.
+         */
+        Inner *reserve_inner(int n) {
+            Inner *spare = nullptr;
+            try {
+                for (; n > 0; --n) {
+                    Inner *inner = new_inner();
+                    inner->child[0] = spare;
+                    spare = inner;
+                }
+            } catch (...) {
+                release_inner(spare);
+                throw;
+            }
+            return spare;
+        }
+
+        void release_inner(Inner *spare) {
+            while (spare) {
+                Inner *nxt = static_cast<Inner *>(spare->child[0]);
+                dispose(spare);
+                spare = nxt;
+            }
+        }
+
+        static Inner *take_inner(Inner *&spare) {
+            Inner *inner = spare;
+            spare = static_cast<Inner *>(inner->child[0]);
+            return inner;
+        }
+
+        /**
+         * inserts val into the subtree at node unless its key is there already; where and index receive
+         *   the element with the key, and inserted whether it is new. returns the new right sibling
+         *   of node if node had to be split, or nullptr.
+         * need is the number of inner nodes a split of node takes above it (one per full ancestor
+         *   in a row, and a new root if they reach it); a leaf split reserves them into spare first.
+         */
+        template<class V>
+        Node *insert(Node *node, V &&val, Leaf *&where, int &index, bool &inserted, int need, Inner *&spare) {
+            if (node->leaf) {
+                Leaf *leaf = static_cast<Leaf *>(node);
+                int i = lower(leaf, val.first);
+                where = leaf;
+                index = i;
+                inserted = !(i < leaf->count && !cmp(val.first, leaf->key(i)));
+                if (!inserted) return nullptr;
+                if (leaf->count < fanout) {
+                    put(leaf, i, std::forward<V>(val));
+                    return nullptr;
+                }
+                // the new element is built, and every node the split takes is allocated, before anything moves
+                typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type slot;
+                value_type *fresh = new(&slot) value_type(std::forward<V>(val));
+                Leaf *right = nullptr;
+                try {
+                    right = new_leaf();
+                    spare = reserve_inner(need);
+                } catch (...) {
+                    if (right) dispose(right);
+                    fresh->~value_type();
+                    throw;
+                }
+                // fanout + 1 elements: the lower (fanout + 1) / 2 stay
+                int mid = (fanout + 1) / 2, keep = i < mid ? mid - 1 : mid;
+                for (int j = keep; j < leaf->count; ++j) leaf->move(j, right, j - keep);
+                right->count = leaf->count - keep;
+                leaf->count = keep;
+                right->next = leaf->next;
+                right->prev = leaf;
+                if (leaf->next) leaf->next->prev = right;
+                else tail = right;
+                leaf->next = right;
+                if (i < mid) {
+                    put(leaf, i, std::move(*fresh));
+                } else {
+                    where = right;
+                    index = i - mid;
+                    put(right, i - mid, std::move(*fresh));
+                }
+                fresh->~value_type();
+                return right;
+            }
+            Inner *inner = static_cast<Inner *>(node);
+            int c = route(inner, val.first);
+            Node *split = insert(inner->child[c], std::forward<V>(val), where, index, inserted,
+                                 inner->count == fanout ? need + 1 : 0, spare);
+            if (!split) return nullptr;
+            for (int j = inner->count - 1; j > c; --j) {
+                inner->move_key(j - 1, inner, j);
+                inner->child[j + 1] = inner->child[j];
+            }
+            new(inner->keys + c) Key(lowest(split));
+            inner->child[c + 1] = split;
+            if (++inner->count <= fanout) return nullptr;
+            // fanout + 1 children: the lower (fanout + 1) / 2 stay, and the key between the halves is dropped
+            Inner *right = take_inner(spare);
+            int mid = (fanout + 1) / 2;
+            for (int j = mid; j < inner->count; ++j) {
+                if (j > mid) inner->move_key(j - 1, right, j - mid - 1);
+                right->child[j - mid] = inner->child[j];
+            }
+            inner->key(mid - 1).~Key();
+            right->count = inner->count - mid;
+            inner->count = mid;
+            return right;
+        }
+
+        /**
+         * removes the element with key from the subtree at node; returns whether node is left with
+         *   fewer than MIN_COUNT elements or children.
+         */
+        bool erase(Node *node, const Key &key) {
+            if (node->leaf) {
+                Leaf *leaf = static_cast<Leaf *>(node);
+                int i = lower(leaf, key);
+                leaf->val(i).~value_type();
+                for (int j = i + 1; j < leaf->count; ++j) leaf->move(j, leaf, j - 1);
+                return --leaf->count < MIN_COUNT;
+            }
+            Inner *inner = static_cast<Inner *>(node);
+            int c = route(inner, key);
+            if (erase(inner->child[c], key)) refill(inner, c);
+            return inner->count < MIN_COUNT;
+        }
+
+        /**
+         * child c of inner is short of elements or children: it takes one from a sibling that can spare
+         *   one, or else is merged with a sibling.
+         */
+        void refill(Inner *inner, int c) {
+            int l = c + 1 < inner->count ? c : c - 1;
+            Node *left = inner->child[l], *right = inner->child[l + 1];
+            if (left->leaf) {
+                Leaf *a = static_cast<Leaf *>(left), *b = static_cast<Leaf *>(right);
+                if (a->count + b->count <= fanout) {
+                    for (int j = 0; j < b->count; ++j) b->move(j, a, a->count + j);
+                    a->count += b->count;
+                    a->next = b->next;
+                    if (b->next) b->next->prev = a;
+                    else tail = a;
+                    dispose(b);
+                } else if (a->count < b->count) {
+                    b->move(0, a, a->count++);
+                    for (int j = 1; j < b->count; ++j) b->move(j, b, j - 1);
+                    --b->count;
+                    inner->set_key(l, b->key(0));
+                    return;
+                } else {
+                    for (int j = b->count; j > 0; --j) b->move(j - 1, b, j);
+                    a->move(--a->count, b, 0);
+                    ++b->count;
+                    inner->set_key(l, b->key(0));
+                    return;
+                }
+            } else {
+                Inner *a = static_cast<Inner *>(left), *b = static_cast<Inner *>(right);
+                if (a->count + b->count <= fanout) {
+                    new(a->keys + a->count - 1) Key(inner->key(l));
+                    for (int j = 0; j < b->count; ++j) {
+                        if (j) b->move_key(j - 1, a, a->count + j - 1);
+                        a->child[a->count + j] = b->child[j];
+                    }
+                    a->count += b->count;
+                    b->count = 0;
+                    dispose(b);
+                } else if (a->count < b->count) {
+                    new(a->keys + a->count - 1) Key(inner->key(l));
+                    a->child[a->count++] = b->child[0];
+                    inner->set_key(l, b->key(0));
+                    b->key(0).~Key();
+                    for (int j = 1; j < b->count; ++j) {
+                        if (j > 1) b->move_key(j - 1, b, j - 2);
+                        b->child[j - 1] = b->child[j];
+                    }
+                    --b->count;
+                    return;
+                } else {
+                    for (int j = b->count; j > 0; --j) {
+                        if (j > 1) b->move_key(j - 2, b, j - 1);
+                        b->child[j] = b->child[j - 1];
+                    }
+                    new(b->keys) Key(inner->key(l));
+                    b->child[0] = a->child[--a->count];
+                    ++b->count;
+                    inner->set_key(l, a->key(a->count - 1));
+                    a->key(a->count - 1).~Key();
+                    return;
+                }
+            }
+            // right was merged into left: drop it and the key before it
+            inner->key(l).~Key();
+            for (int j = l + 1; j + 1 < inner->count; ++j) {
+                inner->move_key(j, inner, j - 1);
+                inner->child[j] = inner->child[j + 1];
+            }
+            --inner->count;
+        }
+
+    public:
+        class const_iterator;
+
+        /**
+         * an element is a leaf and a position in it; end() has no leaf.
+         * if there is anything wrong throw invalid_iterator, like map's iterators.
+         */
+        class iterator {
+            friend class btree_map;
+
+        private:
+            btree_map *map_ptr;
+            Leaf *leaf;
+            int index;
+
+        public:
+            iterator() : map_ptr(nullptr), leaf(nullptr), index(0) {}
+
+            iterator(btree_map *map, Leaf *leaf, int index) : map_ptr(map), leaf(leaf), index(index) {}
+
+            iterator operator++(int) {
+                iterator iter = *this;
+                ++*this;
+                return iter;
+            }
+
+            iterator &operator++() {
+                if (leaf == nullptr) throw invalid_iterator();
+                if (++index == leaf->count) {
+                    leaf = leaf->next;
+                    index = 0;
+                }
+                return *this;
+            }
+
+            iterator operator--(int) {
+                iterator iter = *this;
+                --*this;
+                return iter;
+            }
+
+            iterator &operator--() {
+                if (map_ptr == nullptr) throw invalid_iterator();
+                if (leaf && index) {
+                    --index;
+                    return *this;
+                }
+                Leaf *to = leaf ? leaf->prev : map_ptr->tail;
+                if (to == nullptr) throw invalid_iterator();
+                leaf = to;
+                index = to->count - 1;
+                return *this;
+            }
+
+            value_type &operator*() const {
+                if (leaf == nullptr) throw invalid_iterator();
+                return leaf->val(index);
+            }
+
+            value_type *operator->() const noexcept {
+                if (leaf == nullptr) return nullptr;
+                return &leaf->val(index);
+            }
+
+            bool operator==(const iterator &rhs) const {
+                return map_ptr == rhs.map_ptr && leaf == rhs.leaf && index == rhs.index;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                return map_ptr == rhs.map_ptr && leaf == rhs.leaf && index == rhs.index;
+            }
+
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+
+        class const_iterator {
+            friend class btree_map;
+
+        private:
+            const btree_map *map_ptr;
+            Leaf *leaf;
+            int index;
+
+        public:
+            const_iterator() : map_ptr(nullptr), leaf(nullptr), index(0) {}
+
+            const_iterator(const iterator &other) : map_ptr(other.map_ptr), leaf(other.leaf),
+                                                    index(other.index) {}
+
+            const_iterator(const btree_map *map, Leaf *leaf, int index) : map_ptr(map), leaf(leaf),
+                                                                           index(index) {}
+
+            const_iterator operator++(int) {
+                const_iterator iter = *this;
+                ++*this;
+                return iter;
+            }
+
+            const_iterator &operator++() {
+                if (leaf == nullptr) throw invalid_iterator();
+                if (++index == leaf->count) {
+                    leaf = leaf->next;
+                    index = 0;
+                }
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                const_iterator iter = *this;
+                --*this;
+                return iter;
+            }
+
+            const_iterator &operator--() {
+                if (map_ptr == nullptr) throw invalid_iterator();
+                if (leaf && index) {
+                    --index;
+                    return *this;
+                }
+                Leaf *to = leaf ? leaf->prev : map_ptr->tail;
+                if (to == nullptr) throw invalid_iterator();
+                leaf = to;
+                index = to->count - 1;
+                return *this;
+            }
+
+            const value_type &operator*() const {
+                if (leaf == nullptr) throw invalid_iterator();
+                return leaf->val(index);
+            }
+
+            const value_type *operator->() const noexcept {
+                if (leaf == nullptr) return nullptr;
+                return &leaf->val(index);
+            }
+
+            bool operator==(const iterator &rhs) const {
+                return map_ptr == rhs.map_ptr && leaf == rhs.leaf && index == rhs.index;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                return map_ptr == rhs.map_ptr && leaf == rhs.leaf && index == rhs.index;
+            }
+
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+
+        btree_map() : root(nullptr), head(nullptr), tail(nullptr), num(0), alloc() {}
+
+        explicit btree_map(const Alloc &alloc) : root(nullptr), head(nullptr), tail(nullptr), num(0),
+                                                 alloc(alloc) {}
+
+        btree_map(const btree_map &other) : cmp(other.cmp), alloc(other.alloc) {
+            copy_from(other);
+        }
+
+        /**
+         * takes over the nodes of other, leaving it empty. O(1).
+         */
+        btree_map(btree_map &&other) noexcept : root(other.root), head(other.head), tail(other.tail),
+                                                num(other.num), cmp(other.cmp), alloc(other.alloc) {
+            other.root = nullptr;
+            other.head = other.tail = nullptr;
+            other.num = 0;
+        }
+
+        btree_map &operator=(const btree_map &other) {
+            if (this == &other) return *this;
+            clear();
+            cmp = other.cmp;
+            copy_from(other);
+            return *this;
+        }
+
+        btree_map &operator=(btree_map &&other) noexcept {
+            if (this == &other) return *this;
+            clear();
+            swap(other);
+            return *this;
+        }
+
+        /**
+         * exchanges the contents (and allocators) of the two maps in O(1).
+         * iterators of both maps are invalidated.
+         */
+        void swap(btree_map &other) noexcept {
+            std::swap(root, other.root);
+            std::swap(head, other.head);
+            std::swap(tail, other.tail);
+            std::swap(num, other.num);
+            std::swap(cmp, other.cmp);
+            std::swap(alloc, other.alloc);
+        }
+
+        ~btree_map() {
+            clear();
+        }
+
+        /**
+         * the value mapped to key; throws index_out_of_bound if there is none.
+         */
+        T &at(const Key &key) {
+            iterator it = find(key);
+            if (it == end()) throw index_out_of_bound();
+            return it->second;
+        }
+
+        const T &at(const Key &key) const {
+            const_iterator it = find(key);
+            if (it == cend()) throw index_out_of_bound();
+            return it->second;
+        }
+
+        /**
+         * the value mapped to key, inserting T() for it if there is none.
+         */
+        T &operator[](const Key &key) {
+            iterator it = find(key);
+            if (it != end()) return it->second;
+            return insert(value_type(key, T())).first->second;
+        }
+
+        /**
+         * behave like at() throw index_out_of_bound if such key does not exist.
+         */
+        const T &operator[](const Key &key) const {
+            return at(key);
+        }
+
+        iterator begin() {
+            return iterator(this, head, 0);
+        }
+
+        const_iterator cbegin() const {
+            return const_iterator(this, head, 0);
+        }
+
+        iterator end() {
+            return iterator(this, nullptr, 0);
+        }
+
+        const_iterator cend() const {
+            return const_iterator(this, nullptr, 0);
+        }
+
+        bool empty() const {
+            return num == 0;
+        }
+
+        size_t size() const {
+            return num;
+        }
+
+        void clear() {
+            if (root) clear(root);
+            root = nullptr;
+            head = tail = nullptr;
+            num = 0;
+        }
+
+        /**
+         * insert an element.
+         * return a pair, the first of the pair is
+         *   the iterator to the new element (or the element that prevented the insertion),
+         *   the second one is true if insert successfully, or false.
+         * one descent, which splits the full nodes on the way back up.
+         */
+        pair<iterator, bool> insert(const value_type &value) {
+            return insert_value(value);
+        }
+
+        pair<iterator, bool> insert(value_type &&value) {
+            return insert_value(std::move(value));
+        }
+
+        template<class... Args>
+        pair<iterator, bool> emplace(Args &&... args) {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        /**
+         * erase the element at pos.
+         *
+         * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
+         */
+        void erase(iterator pos) {
+            if (pos.map_ptr != this || pos.leaf == nullptr) throw invalid_iterator();
+            if (pos.index < 0 || pos.index >= pos.leaf->count) throw invalid_iterator();
+            if (find(pos->first) != pos) throw invalid_iterator();
+            erase(root, pos->first);
+            --num;
+            if (root->leaf) {
+                if (root->count == 0) clear();
+            } else if (root->count == 1) {
+                Inner *old = static_cast<Inner *>(root);
+                root = old->child[0];
+                dispose(old);
+            }
+        }
+
+        size_t count(const Key &key) const {
+            if (find(key) == cend()) return 0;
+            return 1;
+        }
+
+        iterator find(const Key &key) {
+            if (!root) return end();
+            Leaf *leaf = leaf_of(key);
+            int i = lower(leaf, key);
+            if (i == leaf->count || cmp(key, leaf->key(i))) return end();
+            return iterator(this, leaf, i);
+        }
+
+        const_iterator find(const Key &key) const {
+            if (!root) return cend();
+            Leaf *leaf = leaf_of(key);
+            int i = lower(leaf, key);
+            if (i == leaf->count || cmp(key, leaf->key(i))) return cend();
+            return const_iterator(this, leaf, i);
+        }
+
+        /**
+         * the first element whose key is not below key, or end(): where a range scan starts.
+         */
+        iterator lower_bound(const Key &key) {
+            if (!root) return end();
+            Leaf *leaf = leaf_of(key);
+            int i = lower(leaf, key);
+            if (i == leaf->count) return iterator(this, leaf->next, 0);
+            return iterator(this, leaf, i);
+        }
+
+        const_iterator lower_bound(const Key &key) const {
+            if (!root) return cend();
+            Leaf *leaf = leaf_of(key);
+            int i = lower(leaf, key);
+            if (i == leaf->count) return const_iterator(this, leaf->next, 0);
+            return const_iterator(this, leaf, i);
+        }
+
+    private:
+        template<class V>
+        pair<iterator, bool> insert_value(V &&value) {
+            if (!root) root = head = tail = new_leaf();
+            Leaf *where = nullptr;
+            int index = 0;
+            bool inserted = false;
+            Inner *spare = nullptr;
+            Node *split;
+            try {
+                split = insert(root, std::forward<V>(value), where, index, inserted, 1, spare);
+            } catch (...) {
+                if (!num) clear();
+                throw;
+            }
+            if (split) {
+                Inner *inner = take_inner(spare);
+                new(inner->keys) Key(lowest(split));
+                inner->child[0] = root;
+                inner->child[1] = split;
+                inner->count = 2;
+                root = inner;
+            }
+            if (inserted) ++num;
+            return pair<iterator, bool>(iterator(this, where, index), inserted);
+        }
+    };
+
+    template<class Key, class T, class Compare, class Alloc, size_t FANOUT>
+    void swap(btree_map<Key, T, Compare, Alloc, FANOUT> &lhs, btree_map<Key, T, Compare, Alloc, FANOUT> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+#include "locked_map.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int READERS = 4;
+const int N = 20000;
+
+void TestConstReaders()
+{
+	std::cout << "Testing concurrent readers of a const map..." << std::endl;
+	sjtu::map<int, std::string> m;
+	for (int i = 0; i < N; ++i) {
+		m[i * 2] = std::to_string(i);
+	}
+	const sjtu::map<int, std::string> &cm = m;
+	std::vector<int> bad(READERS, 0);
+	std::vector<std::thread> readers;
+	for (int k = 0; k < READERS; ++k) {
+		readers.push_back(std::thread([&cm, &bad, k]() {
+			for (int i = k; i < 2 * N; i += 3) {
+				bool hit = cm.count(i) == 1;
+				if (hit != (i % 2 == 0)) ++bad[k];
+				if (hit && cm.at(i) != std::to_string(i / 2)) ++bad[k];
+			}
+			int expect = 0;
+			for (sjtu::map<int, std::string>::const_iterator it = cm.cbegin(); it != cm.cend(); ++it, expect += 2) {
+				if (it->first != expect) ++bad[k];
+			}
+			if (expect != 2 * N) ++bad[k];
+		}));
+	}
+	for (size_t k = 0; k < readers.size(); ++k) {
+		readers[k].join();
+	}
+	int total = 0;
+	for (int k = 0; k < READERS; ++k) {
+		total += bad[k];
+	}
+	std::cout << "mismatches: " << total << std::endl;
+}
+
+/**
+ * a writer keeps value(key) == key * 3 for every key it has inserted, while readers look keys up.
+ */
+void TestLockedMap()
+{
+	std::cout << "Testing locked_map with one writer and " << READERS << " readers..." << std::endl;
+	sjtu::locked_map<int, long long> m;
+	std::atomic<bool> done(false);
+	std::vector<int> bad(READERS, 0);
+	std::vector<std::thread> readers;
+	for (int k = 0; k < READERS; ++k) {
+		readers.push_back(std::thread([&m, &done, &bad, k]() {
+			int i = k;
+			long long value;
+			while (!done.load()) {
+				if (m.find(i, value) && value != i * 3LL) ++bad[k];
+				i = (i + 7) % N;
+			}
+		}));
+	}
+	for (int i = 0; i < N; ++i) {
+		m.assign(i, i * 3LL);
+		if (i % 3 == 0) m.erase(i / 2);
+	}
+	done.store(true);
+	for (size_t k = 0; k < readers.size(); ++k) {
+		readers[k].join();
+	}
+	int total = 0;
+	for (int k = 0; k < READERS; ++k) {
+		total += bad[k];
+	}
+	std::cout << "mismatches: " << total << std::endl;
+	std::cout << m.size() << " " << m.count(N - 1) << " " << m.count(0) << std::endl;
+	std::cout << m.insert(sjtu::pair<const int, long long>(N - 1, 0)) << " " << m.assign(N, 1) << " " << m.erase(N) << std::endl;
+	long long sum = m.read([](const sjtu::map<int, long long> &data) {
+		long long s = 0;
+		for (sjtu::map<int, long long>::const_iterator it = data.cbegin(); it != data.cend(); ++it) {
+			s += it->second;
+		}
+		return s;
+	});
+	std::cout << sum << std::endl;
+	m.write([](sjtu::map<int, long long> &data) {
+		data.clear();
+	});
+	std::cout << m.empty() << std::endl;
+}
+
+int main()
+{
+	TestConstReaders();
+	TestLockedMap();
+	return 0;
+}
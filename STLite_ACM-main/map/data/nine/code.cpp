@@ -0,0 +1,220 @@
+#include "btree_map.hpp"
+
+#include <iostream>
+#include <new>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+/**
+ * a key with no default constructor that counts its live copies.
+ */
+class Ticket {
+public:
+	static int alive;
+	int *val;
+	Ticket(int v) : val(new int(v)) {
+		++alive;
+	}
+	Ticket(const Ticket &other) : val(new int(*other.val)) {
+		++alive;
+	}
+	Ticket &operator=(const Ticket &other) {
+		*val = *other.val;
+		return *this;
+	}
+	~Ticket() {
+		delete val;
+		--alive;
+	}
+};
+
+int Ticket::alive = 0;
+
+/**
+ * a value whose copy throws once copies_left runs out.
+ */
+int copies_left = -1;
+
+class Fragile {
+public:
+	int val;
+	Fragile(int v) : val(v) {}
+	Fragile(const Fragile &other) : val(other.val) {
+		if (copies_left == 0) throw std::runtime_error("copy");
+		if (copies_left > 0) --copies_left;
+	}
+	Fragile(Fragile &&other) noexcept : val(other.val) {}
+};
+
+/**
+ * an allocator that throws once allocations_left runs out.
+ */
+int allocations_left = -1;
+
+template<class T>
+class Scarce {
+public:
+	typedef T value_type;
+	Scarce() {}
+	template<class U>
+	Scarce(const Scarce<U> &) {}
+	T *allocate(size_t n) {
+		if (allocations_left == 0) throw std::bad_alloc();
+		if (allocations_left > 0) --allocations_left;
+		return static_cast<T *>(::operator new(n * sizeof(T)));
+	}
+	void deallocate(T *p, size_t) {
+		::operator delete(p);
+	}
+	template<class U>
+	bool operator==(const Scarce<U> &) const {
+		return true;
+	}
+	template<class U>
+	bool operator!=(const Scarce<U> &) const {
+		return false;
+	}
+};
+
+struct TicketLess {
+	bool operator()(const Ticket &a, const Ticket &b) const {
+		return *a.val < *b.val;
+	}
+};
+
+void TestSmallFanout()
+{
+	std::cout << "Testing btree_map with fanout 4..." << std::endl;
+	typedef sjtu::btree_map<int, std::string, std::less<int>, sjtu::allocator<sjtu::pair<const int, std::string>>, 4> Map;
+	Map m;
+	for (int i = 0; i < 10000; ++i) {
+		int key = i * 7919 % 10000;
+		m[key] = std::to_string(key);
+	}
+	std::cout << m.size() << " " << m.insert(sjtu::pair<const int, std::string>(5, "x")).second << " " << m.at(5) << std::endl;
+	for (int i = 1; i < 10000; i += 2) {
+		m.erase(m.find(i));
+	}
+	long long sum = 0;
+	int prev = -1, bad = 0;
+	for (Map::iterator it = m.begin(); it != m.end(); ++it) {
+		if (it->first <= prev || it->second != std::to_string(it->first)) ++bad;
+		prev = it->first;
+		sum += it->first;
+	}
+	std::cout << m.size() << " " << sum << " " << bad << std::endl;
+	const Map c(m);
+	int expect = 9998;
+	Map::const_iterator it = c.cend();
+	do {
+		--it;
+		if (it->first != expect) ++bad;
+		expect -= 2;
+	} while (it != c.cbegin());
+	std::cout << expect << " " << bad << std::endl;
+	int in_range = 0;
+	for (Map::const_iterator jt = c.lower_bound(4001); jt != c.cend() && jt->first < 5000; ++jt) {
+		++in_range;
+	}
+	std::cout << in_range << " " << (c.lower_bound(10000) == c.cend()) << std::endl;
+	int thrown = 0;
+	try {
+		m.at(1);
+	} catch (...) {
+		++thrown;
+	}
+	try {
+		m.erase(m.end());
+	} catch (...) {
+		++thrown;
+	}
+	try {
+		Map::iterator kt = m.begin();
+		--kt;
+	} catch (...) {
+		++thrown;
+	}
+	try {
+		m.erase(const_cast<Map &>(c).find(0));
+	} catch (...) {
+		++thrown;
+	}
+	std::cout << thrown << std::endl;
+	while (!m.empty()) {
+		m.erase(m.begin());
+	}
+	std::cout << m.size() << " " << (m.begin() == m.end()) << " " << c.size() << std::endl;
+}
+
+void TestClassKey()
+{
+	std::cout << "Testing btree_map with a class key..." << std::endl;
+	{
+		sjtu::btree_map<Ticket, Ticket, TicketLess> m;
+		for (int i = 0; i < 3000; ++i) {
+			m.insert(sjtu::pair<const Ticket, Ticket>(Ticket(i * 13 % 3000), Ticket(i)));
+		}
+		for (int i = 0; i < 3000; i += 3) {
+			m.erase(m.find(Ticket(i)));
+		}
+		sjtu::btree_map<Ticket, Ticket, TicketLess> copy;
+		copy = m;
+		sjtu::btree_map<Ticket, Ticket, TicketLess> moved(std::move(copy));
+		long long sum = 0;
+		for (sjtu::btree_map<Ticket, Ticket, TicketLess>::const_iterator it = moved.cbegin(); it != moved.cend(); ++it) {
+			sum += *it->first.val;
+		}
+		std::cout << moved.size() << " " << copy.size() << " " << sum << std::endl;
+		m.clear();
+		std::cout << m.size() << " " << moved.count(Ticket(1)) << " " << moved.count(Ticket(3)) << std::endl;
+	}
+	std::cout << "alive: " << Ticket::alive << std::endl;
+}
+
+/**
+ * before each insert of a growing map of fanout 4, the same insert is tried with its element copy
+ *   throwing and with each of its first node allocations throwing; a throwing insert must leave
+ *   the map as it was.
+ */
+void TestThrowingInsert()
+{
+	std::cout << "Testing btree_map inserts that throw..." << std::endl;
+	typedef sjtu::btree_map<int, Fragile, std::less<int>, Scarce<sjtu::pair<const int, Fragile>>, 4> Map;
+	Map m;
+	std::set<int> keys;
+	int thrown = 0, bad = 0;
+	for (int step = 0; step < 500; ++step) {
+		sjtu::pair<const int, Fragile> value(step * 37 % 500, Fragile(step));
+		bool done = false;
+		for (int budget = -1; budget < 4 && !done; ++budget) {
+			try {
+				copies_left = budget < 0 ? 0 : -1;
+				allocations_left = budget;
+				done = m.insert(value).second;
+			} catch (...) {
+				++thrown;
+			}
+			copies_left = allocations_left = -1;
+			if (done) keys.insert(value.first);
+			std::set<int>::iterator jt = keys.begin();
+			for (Map::const_iterator it = m.cbegin(); it != m.cend(); ++it, ++jt) {
+				if (jt == keys.end() || it->first != *jt) ++bad;
+			}
+			if (m.size() != keys.size()) ++bad;
+		}
+		if (!done) {
+			m.insert(value);
+			keys.insert(value.first);
+		}
+	}
+	std::cout << thrown << " " << bad << " " << m.size() << " " << m.at(37).val << std::endl;
+}
+
+int main()
+{
+	TestSmallFanout();
+	TestClassKey();
+	TestThrowingInsert();
+	return 0;
+}
@@ -0,0 +1,136 @@
+#include "map.hpp"
+
+#include <iostream>
+#include <map>
+#include <string>
+
+unsigned rand_state = 2333;
+
+int next_rand()
+{
+	rand_state = rand_state * 1103515245 + 12345;
+	return int(rand_state >> 8 & 0x7fffff);
+}
+
+/**
+ * a value with no default constructor that counts its live copies.
+ */
+class Counted {
+public:
+	static int alive;
+	std::string val;
+	Counted(const std::string &v) : val(v) {
+		++alive;
+	}
+	Counted(const Counted &other) : val(other.val) {
+		++alive;
+	}
+	Counted &operator=(const Counted &other) {
+		val = other.val;
+		return *this;
+	}
+	~Counted() {
+		--alive;
+	}
+};
+
+int Counted::alive = 0;
+
+template<class Map, class Model>
+bool same(const Map &m, const Model &model)
+{
+	if (m.size() != model.size()) return false;
+	typename Model::const_iterator jt = model.begin();
+	for (typename Map::const_iterator it = m.cbegin(); it != m.cend(); ++it, ++jt) {
+		if (it->first != jt->first || it->second.val != jt->second) return false;
+	}
+	jt = model.end();
+	for (typename Map::const_iterator it = m.cend(); it != m.cbegin();) {
+		--it;
+		--jt;
+		if (it->first != jt->first) return false;
+	}
+	return true;
+}
+
+template<class Balance>
+void TestEngine(const char *name)
+{
+	std::cout << "Testing map on the " << name << " engine..." << std::endl;
+	typedef sjtu::map<int, Counted, std::less<int>, sjtu::allocator<sjtu::pair<const int, Counted>>, Balance> Map;
+	typedef sjtu::pair<const int, Counted> Value;
+	{
+		Map m;
+		std::map<int, std::string> model;
+		int bad = 0;
+		for (int step = 0; step < 100000; ++step) {
+			int key = next_rand() % 20000;
+			if (next_rand() % 3) {
+				std::string val = std::to_string(step);
+				sjtu::pair<typename Map::iterator, bool> res = m.insert(Value(key, Counted(val)));
+				bool fresh = model.insert(std::make_pair(key, val)).second;
+				if (res.second != fresh || res.first->first != key) ++bad;
+			} else {
+				typename Map::iterator it = m.find(key);
+				if ((it == m.end()) != (model.count(key) == 0)) ++bad;
+				if (it != m.end()) {
+					m.erase(it);
+					model.erase(key);
+				}
+			}
+		}
+		std::cout << m.size() << " " << bad << " " << same(m, model) << std::endl;
+
+		Map copy(m);
+		Map assigned;
+		assigned.insert(Value(-1, Counted("gone")));
+		assigned = m;
+		for (int key = 0; key < 20000; key += 2) {
+			typename Map::iterator it = m.find(key);
+			if (it != m.end()) m.erase(it);
+		}
+		std::cout << m.size() << " " << same(copy, model) << " " << same(assigned, model) << std::endl;
+		for (typename std::map<int, std::string>::iterator it = model.begin(); it != model.end();) {
+			if (it->first % 2 == 0) it = model.erase(it);
+			else ++it;
+		}
+		std::cout << same(m, model) << " " << copy.count(0) + copy.count(1) << " " << m.count(0) << std::endl;
+
+		Map ascending;
+		for (int key = 0; key < 200000; ++key) {
+			ascending.insert(Value(key, Counted("")));
+		}
+		for (int key = 199999; key >= 0; key -= 3) {
+			ascending.erase(ascending.find(key));
+		}
+		long long sum = 0;
+		int prev = -1;
+		for (typename Map::const_iterator it = ascending.cbegin(); it != ascending.cend(); ++it) {
+			if (it->first <= prev) ++bad;
+			prev = it->first;
+			sum += it->first;
+		}
+		std::cout << ascending.size() << " " << sum << " " << bad << std::endl;
+		int thrown = 0;
+		try {
+			m.erase(copy.begin());
+		} catch (...) {
+			++thrown;
+		}
+		try {
+			m.at(-5);
+		} catch (...) {
+			++thrown;
+		}
+		m.clear();
+		std::cout << thrown << " " << m.size() << " " << (m.begin() == m.end()) << std::endl;
+	}
+	std::cout << "alive: " << Counted::alive << std::endl;
+}
+
+int main()
+{
+	TestEngine<sjtu::red_black>("red_black");
+	TestEngine<sjtu::avl>("avl");
+	return 0;
+}
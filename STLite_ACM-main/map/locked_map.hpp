@@ -0,0 +1,155 @@
+#ifndef SJTU_LOCKED_MAP_HPP
+#define SJTU_LOCKED_MAP_HPP
+
+#include "map.hpp"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace sjtu {
+
+    /**
+     * a map shared between threads behind a reader/writer lock. lookups hold the lock shared and run
+     *   concurrently, which is sound because the const operations of map only read the tree;
+     *   updates hold it exclusively, and a waiting update holds new lookups back so a steady stream
+     *   of them cannot starve it.
+     * values are copied out rather than referenced, so nothing points into the map once the lock is released.
+     *   read and write run a function on the map itself under the lock, for anything the members below
+     *   do not cover; the function must not let references or iterators escape.
+     */
+    template<
+            class Key,
+            class T,
+            class Compare = std::less<Key>,
+            class Alloc = allocator<pair<const Key, T>>,
+            class Balance = treap
+    >
+    class locked_map {
+    public:
+        typedef map<Key, T, Compare, Alloc, Balance> map_type;
+        typedef typename map_type::value_type value_type;
+
+    private:
+        mutable std::shared_timed_mutex lock;
+        map_type data;
+
+        /**
+         * the number of writers waiting for the lock. shared_timed_mutex (a pthread rwlock) keeps admitting
+         *   readers while a writer waits, so readers step aside by themselves while this is nonzero.
+         */
+        mutable std::atomic<int> writers_waiting;
+
+        std::shared_lock<std::shared_timed_mutex> read_lock() const {
+            while (writers_waiting.load(std::memory_order_acquire)) std::this_thread::yield();
+            return std::shared_lock<std::shared_timed_mutex>(lock);
+        }
+
+        std::unique_lock<std::shared_timed_mutex> write_lock() {
+            writers_waiting.fetch_add(1, std::memory_order_acq_rel);
+            try {
+                std::unique_lock<std::shared_timed_mutex> guard(lock);
+                writers_waiting.fetch_sub(1, std::memory_order_acq_rel);
+                return guard;
+            } catch (...) {
+                writers_waiting.fetch_sub(1, std::memory_order_acq_rel);
+                throw;
+            }
+        }
+
+    public:
+        locked_map() : writers_waiting(0) {}
+
+        explicit locked_map(const Alloc &alloc) : data(alloc), writers_waiting(0) {}
+
+        locked_map(const locked_map &) = delete;
+
+        locked_map &operator=(const locked_map &) = delete;
+
+        /**
+         * copies the value mapped to key into value; returns false, leaving value alone, if there is none.
+         */
+        bool find(const Key &key, T &value) const {
+            std::shared_lock<std::shared_timed_mutex> guard = read_lock();
+            typename map_type::const_iterator it = data.find(key);
+            if (it == data.cend()) return false;
+            value = it->second;
+            return true;
+        }
+
+        size_t count(const Key &key) const {
+            std::shared_lock<std::shared_timed_mutex> guard = read_lock();
+            return data.count(key);
+        }
+
+        size_t size() const {
+            std::shared_lock<std::shared_timed_mutex> guard = read_lock();
+            return data.size();
+        }
+
+        bool empty() const {
+            std::shared_lock<std::shared_timed_mutex> guard = read_lock();
+            return data.empty();
+        }
+
+        /**
+         * inserts value unless its key is present; returns whether it was inserted.
+         */
+        bool insert(const value_type &value) {
+            std::unique_lock<std::shared_timed_mutex> guard = write_lock();
+            return data.insert(value).second;
+        }
+
+        /**
+         * maps key to value, inserting or overwriting; returns whether key was new.
+         */
+        bool assign(const Key &key, const T &value) {
+            std::unique_lock<std::shared_timed_mutex> guard = write_lock();
+            typename map_type::iterator it = data.find(key);
+            if (it == data.end()) {
+                data.insert(value_type(key, value));
+                return true;
+            }
+            it->second = value;
+            return false;
+        }
+
+        /**
+         * removes key; returns whether it was present.
+         */
+        bool erase(const Key &key) {
+            std::unique_lock<std::shared_timed_mutex> guard = write_lock();
+            typename map_type::iterator it = data.find(key);
+            if (it == data.end()) return false;
+            data.erase(it);
+            return true;
+        }
+
+        void clear() {
+            std::unique_lock<std::shared_timed_mutex> guard = write_lock();
+            data.clear();
+        }
+
+        /**
+         * returns f(map) with f given const access under the shared lock.
+         */
+        template<class F>
+        auto read(F f) const -> decltype(f(data)) {
+            std::shared_lock<std::shared_timed_mutex> guard = read_lock();
+            return f(data);
+        }
+
+        /**
+         * returns f(map) with f given full access under the exclusive lock.
+         */
+        template<class F>
+        auto write(F f) -> decltype(f(data)) {
+            std::unique_lock<std::shared_timed_mutex> guard = write_lock();
+            return f(data);
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,83 @@
+#include "map.hpp"
+#include "locked_map.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+/**
+ * lookup throughput of one map shared by 1 .. 8 threads, each doing LOOKUPS random lookups in a map of N keys:
+ *   through plain const access with no lock (possible because const operations only read the tree),
+ *   through locked_map, and through locked_map with one operation in a hundred an assign instead.
+ * the table gives millions of operations per second summed over the threads.
+ */
+const int N = 1000000;
+const int LOOKUPS = 200000;
+
+typedef sjtu::map<int, int> Map;
+
+template<class Body>
+double Run(int threads, Body body) {
+    std::vector<std::thread> pool;
+    std::chrono::steady_clock::time_point from = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) pool.push_back(std::thread(body, t));
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - from).count();
+    return double(threads) * LOOKUPS / seconds / 1e6;
+}
+
+unsigned Next(unsigned &seed) {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+int main() {
+    Map plain;
+    sjtu::locked_map<int, int> locked;
+    for (int i = 0; i < N; ++i) {
+        plain[i * 2] = i;
+        locked.assign(i * 2, i);
+    }
+    std::atomic<long long> checksum(0);
+    const Map &shared = plain;
+    printf("%d keys, %u hardware threads\n", N, std::thread::hardware_concurrency());
+    printf("%7s %12s %12s %12s   (million operations per second)\n", "threads", "const map", "locked_map",
+           "1% writes");
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        printf("%7d", threads);
+        printf(" %12.2f", Run(threads, [&](int t) {
+            unsigned seed = t + 1;
+            long long sum = 0;
+            for (int i = 0; i < LOOKUPS; ++i) {
+                Map::const_iterator it = shared.find(int(Next(seed) % (2 * N)));
+                if (it != shared.cend()) sum += it->second;
+            }
+            checksum += sum;
+        }));
+        printf(" %12.2f", Run(threads, [&](int t) {
+            unsigned seed = t + 1;
+            long long sum = 0;
+            int value;
+            for (int i = 0; i < LOOKUPS; ++i) {
+                if (locked.find(int(Next(seed) % (2 * N)), value)) sum += value;
+            }
+            checksum += sum;
+        }));
+        printf(" %12.2f\n", Run(threads, [&](int t) {
+            unsigned seed = t + 1;
+            long long sum = 0;
+            int value;
+            for (int i = 0; i < LOOKUPS; ++i) {
+                int key = int(Next(seed) % (2 * N));
+                if (i % 100 == 0) locked.assign(key, i);
+                else if (locked.find(key, value)) sum += value;
+            }
+            checksum += sum;
+        }));
+        fflush(stdout);
+    }
+    printf("checksum %lld\n", checksum.load());
+    return 0;
+}
@@ -9,20 +9,45 @@
 #include <cstddef>
 #include "utility.hpp"
 #include "exceptions.hpp"
+#include "allocator.hpp"
 
 #include<ctime>
 #include<cstdlib>
 #include <iostream>
-#include <random>
-
-std::mt19937 rnd(2333);
+#include <memory>
+#include <new>
+#include <type_traits>
 
 namespace sjtu {
 
+    /**
+     * the balancing schemes of map, chosen by its Balance parameter. treap (the default) is a treap kept
+     *   by split and merge with random priorities, expected O(log n) depth; red_black and avl rebalance
+     *   by rotations and guarantee O(log n) depth, with avl the shallower and red_black rotating less
+     *   on updates. all three have the same interface and iterators.
+     */
+    struct treap {
+    };
+
+    struct red_black {
+    };
+
+    struct avl {
+    };
+
+    /**
+     * const operations are physically read-only: the const member functions and every operation of
+     *   const_iterator (lookups, at, count, size, cbegin/cend, ++ and --) descend or step along the tree
+     *   without writing to any node, link or counter of it. any number of threads may therefore use
+     *   one map through const access at once, provided no thread modifies it in the meantime;
+     *   locked_map (locked_map.hpp) pairs a map with a reader/writer lock for the general case.
+     */
     template<
             class Key,
             class T,
-            class Compare = std::less<Key>
+            class Compare = std::less<Key>,
+            class Alloc = allocator<pair<const Key, T>>,
+            class Balance = treap
     >
     class map {
     public:
@@ -33,84 +58,306 @@ namespace sjtu {
          */
         typedef pair<const Key, T> value_type;
     private:
+        typedef std::allocator_traits<Alloc> alloc_traits;
+
+        /**
+         * allocate one U from alloc rebound to U and construct it from args.
+         */
+        template<class U, class... Args>
+        static U *create(const Alloc &alloc, Args &&... args) {
+            typename alloc_traits::template rebind_alloc<U> a(alloc);
+            typedef typename alloc_traits::template rebind_traits<U> traits;
+            U *p = traits::allocate(a, 1);
+            try {
+                new(p) U(std::forward<Args>(args)...);
+            } catch (...) {
+                traits::deallocate(a, p, 1);
+                throw;
+            }
+            return p;
+        }
+
+        template<class U>
+        static void dispose(const Alloc &alloc, U *p) {
+            typename alloc_traits::template rebind_alloc<U> a(alloc);
+            p->~U();
+            alloc_traits::template rebind_traits<U>::deallocate(a, p, 1);
+        }
+
+        /**
+         * parent is kept up to date by update(), which every split and merge calls on each node whose
+         *   children it changes, and by Tree::replace and the rotations; iterators step along it
+         *   without touching the tree.
+         * balance is the engine's bookkeeping: the heap priority in a treap, the colour in a red-black tree
+         *   and the subtree height in an AVL tree.
+         */
         class Node {
         public:
-            Node *left = nullptr, *right = nullptr;
+            Node *left = nullptr, *right = nullptr, *parent = nullptr;
             value_type val;
-            int size, priority;
+            int balance = 0;
+
+            Node() : left(nullptr), right(nullptr) {//todo:avoid using
+            }
 
-            Node() : size(0), left(nullptr), right(nullptr) {//todo:avoid using
-                priority = rnd();
+            Node(const value_type &v) : val(v), left(nullptr), right(nullptr) {
             }
 
-            Node(const value_type &v) : size(1), val(v), left(nullptr), right(nullptr) {
-                priority = rnd();
+            Node(value_type &&v) : val(std::move(v)), left(nullptr), right(nullptr) {
             }
 
             ~Node() {
-                left = right = nullptr;
-                size = 0;
+                left = right = parent = nullptr;
             }
 
             void update() {
-                size = 1 + (left != nullptr ? left->size : 0) + (right != nullptr ? right->size : 0);
+                if (left) left->parent = this;
+                if (right) right->parent = this;
             }
         };
 
-        class Treap {
+        /**
+         * the binary search tree the engines share: node storage, copying, lookups, in-order stepping
+         *   and the relinking primitives. each engine adds insert(val) and remove(node) on top.
+         */
+        class Tree {
         public:
             Node *root;
-            int size;/////fake_size
+            int size;//the number of nodes
             Compare cmp;
+            Alloc alloc;
+            /**
+             * nodes come from a per-tree slab pool: removed nodes are recycled by later inserts
+             *   and the slabs are released together when the tree goes away.
+             */
+            slab_pool<Node, Alloc> pool;
 
-            Treap() : root(nullptr), size(0) {////todo:avoid using
-            }
-
-            Treap(const value_type &v) : root(nullptr) {
-                root = new Node(v);
-                size = root->size;
+            Tree(const Alloc &alloc) : root(nullptr), size(0), alloc(alloc), pool(alloc) {
             }
 
-            Treap(const Treap &other) : root(nullptr) {
+            /**
+             * copies the shape and the balance of every node, so the copy satisfies the engine's invariants.
+             */
+            Tree(const Tree &other) : root(nullptr), size(0), alloc(other.alloc), pool(other.alloc) {
                 if (other.root) {
-                    root = new_node(other.root);
-                    size = root->size;
+                    set_root(new_node(other.root));
+                    size = other.size;
                 }
             }
 
-            Treap &operator=(const Treap &other) {
+            Tree &operator=(const Tree &other) {
                 if (this == &other) return *this;
-                root = new_node(other);
-                size = root->size;
+                clear(root);
+                set_root(other.root ? new_node(other.root) : nullptr);
+                size = other.size;
                 return *this;
             }
 
+            void set_root(Node *node) {
+                root = node;
+                if (root) root->parent = nullptr;
+            }
+
             void clear(Node *node) {
                 if (node == nullptr) return;
                 if (node->right)
                     clear(node->right);
                 if (node->left) clear(node->left);
-                delete node;
+                delete_node(node);
             }
 
-            ~Treap() {
-                clear(root);
+            ~Tree() {
+                // trivially destructible nodes need no walk, their slabs are simply released
+                if (!std::is_trivially_destructible<value_type>::value) clear(root);
+                pool.release();
                 root = nullptr;
                 size = 0;
             }
 
+            template<class V>
+            Node *create_node(V &&val) {
+                Node *node = pool.allocate();
+                try {
+                    new(node) Node(std::forward<V>(val));
+                } catch (...) {
+                    pool.deallocate(node);
+                    throw;
+                }
+                return node;
+            }
+
+            void delete_node(Node *node) {
+                node->~Node();
+                pool.deallocate(node);
+            }
+
             Node *new_node(Node *other) {
-                Node *node = new Node(other->val);
+                Node *node = create_node(other->val);
+                node->balance = other->balance;
                 if (other->left) node->left = new_node(other->left);
                 if (other->right) node->right = new_node(other->right);
-                node->size = other->size;
+                node->update();
                 return node;
             }
 
+            /**
+             * the node with key, or nullptr: one descent, and the tree is only read.
+             */
+            Node *find(const Key &key) const {
+                Node *pos = root;
+                while (pos) {
+                    if (cmp(key, pos->val.first)) pos = pos->left;
+                    else if (cmp(pos->val.first, key)) pos = pos->right;
+                    else return pos;
+                }
+                return nullptr;
+            }
+
+            /**
+             * hangs node, whose key must not be in the tree yet, as a leaf where a descent for its key ends.
+             */
+            void link_leaf(Node *node) {
+                Node *parent = nullptr, *pos = root;
+                bool left = false;
+                while (pos) {
+                    parent = pos;
+                    left = cmp(node->val.first, pos->val.first);
+                    pos = left ? pos->left : pos->right;
+                }
+                replace(parent, left, node);
+                ++size;
+            }
+
+            /**
+             * makes node the left (or right) child of parent, or the root if parent is nullptr.
+             */
+            void replace(Node *parent, bool left, Node *node) {
+                if (!parent) {
+                    set_root(node);
+                    return;
+                }
+                if (left) parent->left = node;
+                else parent->right = node;
+                if (node) node->parent = parent;
+            }
+
+            /**
+             * lifts the right (left) child of node into its place; returns that child.
+             */
+            Node *rotate_left(Node *node) {
+                Node *pivot = node->right, *parent = node->parent;
+                bool left = parent && parent->left == node;
+                node->right = pivot->left;
+                pivot->left = node;
+                node->update();
+                pivot->update();
+                replace(parent, left, pivot);
+                return pivot;
+            }
+
+            Node *rotate_right(Node *node) {
+                Node *pivot = node->left, *parent = node->parent;
+                bool left = parent && parent->left == node;
+                node->left = pivot->right;
+                pivot->right = node;
+                node->update();
+                pivot->update();
+                replace(parent, left, pivot);
+                return pivot;
+            }
+
+            /**
+             * swaps the places (and balances) of node, which has two children, and its in-order successor,
+             *   leaving node with no left child. nodes are relinked rather than values moved, so iterators
+             *   to either stay valid.
+             */
+            void swap_with_successor(Node *node) {
+                Node *succ = node->right;
+                while (succ->left) succ = succ->left;
+                Node *parent = node->parent, *succ_right = succ->right;
+                bool left = parent && parent->left == node;
+                std::swap(node->balance, succ->balance);
+                succ->left = node->left;
+                if (succ == node->right) {
+                    succ->right = node;
+                } else {
+                    succ->right = node->right;
+                    succ->parent->left = node;
+                    node->parent = succ->parent;
+                }
+                succ->update();
+                node->left = nullptr;
+                node->right = succ_right;
+                node->update();
+                replace(parent, left, succ);
+            }
+
+            int sze() const {
+                return size;
+            }
+
+            Node *first() const {
+                Node *pos = root;
+                while (pos && pos->left) pos = pos->left;
+                return pos;
+            }
+
+            Node *last() const {
+                Node *pos = root;
+                while (pos && pos->right) pos = pos->right;
+                return pos;
+            }
+
+            /**
+             * the in-order neighbours of node (nullptr past either end), found through the child
+             *   and parent links: O(1) amortized over a scan, and the tree is only read.
+             */
+            static Node *next(const Node *node) {
+                if (node->right) {
+                    Node *pos = node->right;
+                    while (pos->left) pos = pos->left;
+                    return pos;
+                }
+                while (node->parent && node->parent->right == node) node = node->parent;
+                return node->parent;
+            }
+
+            static Node *prev(const Node *node) {
+                if (node->left) {
+                    Node *pos = node->left;
+                    while (pos->right) pos = pos->right;
+                    return pos;
+                }
+                while (node->parent && node->parent->left == node) node = node->parent;
+                return node->parent;
+            }
+        };
+
+        /**
+         * a treap kept by split and merge. priorities come from a xorshift generator owned by the treap,
+         *   so maps do not share (or race on) a global one, and a copy carries its priorities along.
+         */
+        class Treap : public Tree {
+        public:
+            using Tree::root;
+            using Tree::size;
+            using Tree::cmp;
+            unsigned seed;
+
+            Treap(const Alloc &alloc) : Tree(alloc), seed(2333) {
+            }
+
+            int priority() {
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                return int(seed >> 1);
+            }
+
             Node *merge(Node *aa, Node *bb) {
                 if (!aa) return bb;
                 if (!bb) return aa;
-                if (aa->priority < bb->priority) {
+                if (aa->balance < bb->balance) {
                     aa->right = merge(aa->right, bb);
                     aa->update();
                     return aa;
@@ -121,91 +368,277 @@ namespace sjtu {
                 }
             }
 
-            pair<Node *, Node *> split(Node *pos, const int &kk) {
-                if (!pos) return pair<Node *, Node *>(nullptr, nullptr);
-                if (kk == 0) return pair<Node *, Node *>(nullptr, pos);
-                if (!pos->left && !pos->right) return pair<Node *, Node *>(pos, nullptr);
-
-                if (pos->left && pos->left->size >= kk) {
-                    pair<Node *, Node *> tmp = split(pos->left, kk);
-                    pos->left = tmp.second;
-                    pos->update();
-                    tmp.second = pos;
-                    return tmp;
+            /**
+             * splits the subtree at pos into the nodes with keys below key (left) and above it (right);
+             *   key itself must not be in it.
+             */
+            void split(Node *pos, const Key &key, Node *&left, Node *&right) {
+                if (!pos) {
+                    left = right = nullptr;
+                    return;
+                }
+                if (cmp(pos->val.first, key)) {
+                    split(pos->right, key, pos->right, right);
+                    left = pos;
                 } else {
-                    pair<Node *, Node *> tmp = split(pos->right, kk - 1 - (pos->left ? pos->left->size : 0));
-                    pos->right = tmp.first;
-                    pos->update();
-                    tmp.first = pos;
-                    return tmp;
+                    split(pos->left, key, left, pos->left);
+                    right = pos;
                 }
+                pos->update();
             }
 
-            bool exist(Node *pos, const Key &key) const {
-//                if (pos == nullptr) return false;
-//                if (!cmp(pos->val.first, key) && !cmp(key, pos->val.first)) return true;
-//                return cmp(key, pos->val.first) ? exist(pos->left, key) : exist(pos->right, key);
+            /**
+             * links a node for val, whose key must not be in the treap yet. one descent along the key's path
+             *   finds the first node the new one outranks, and the subtree there is split by the key
+             *   into the children of the new node.
+             */
+            template<class V>
+            Node *insert(V &&val) {
+                Node *node = this->create_node(std::forward<V>(val));
+                node->balance = priority();
+                Node *parent = nullptr, *pos = root;
+                bool left = false;
+                while (pos && pos->balance < node->balance) {
+                    parent = pos;
+                    left = cmp(node->val.first, pos->val.first);
+                    pos = left ? pos->left : pos->right;
+                }
+                split(pos, node->val.first, node->left, node->right);
+                node->update();
+                this->replace(parent, left, node);
+                ++size;
+                return node;
+            }
 
-                while (pos) {
-                    if (!cmp(pos->val.first, key) && !cmp(key, pos->val.first)) return true;
-                    if (cmp(key, pos->val.first)) pos = pos->left;
-                    else {
-                        pos = pos->right;
+            /**
+             * unlinks node, merging its subtrees in its place, and frees it.
+             */
+            void remove(Node *node) {
+                Node *parent = node->parent;
+                this->replace(parent, parent && parent->left == node, merge(node->left, node->right));
+                --size;
+                this->delete_node(node);
+            }
+        };
+
+        /**
+         * a red-black tree: at most 2 log(n + 1) levels, and every insert or remove rotates O(1) times.
+         *   a missing child counts as black.
+         */
+        class RedBlack : public Tree {
+        public:
+            using Tree::root;
+            using Tree::size;
+            static const int RED = 0, BLACK = 1;
+
+            RedBlack(const Alloc &alloc) : Tree(alloc) {
+            }
+
+            static bool red(const Node *node) {
+                return node && node->balance == RED;
+            }
+
+            template<class V>
+            Node *insert(V &&val) {
+                Node *node = this->create_node(std::forward<V>(val));
+                node->balance = RED;
+                this->link_leaf(node);
+                Node *pos = node;
+                while (red(pos->parent)) {
+                    Node *parent = pos->parent, *grand = parent->parent;
+                    if (parent == grand->left) {
+                        Node *uncle = grand->right;
+                        if (red(uncle)) {
+                            parent->balance = uncle->balance = BLACK;
+                            grand->balance = RED;
+                            pos = grand;
+                            continue;
+                        }
+                        if (pos == parent->right) {
+                            this->rotate_left(parent);
+                            parent = pos;
+                        }
+                        parent->balance = BLACK;
+                        grand->balance = RED;
+                        this->rotate_right(grand);
+                    } else {
+                        Node *uncle = grand->left;
+                        if (red(uncle)) {
+                            parent->balance = uncle->balance = BLACK;
+                            grand->balance = RED;
+                            pos = grand;
+                            continue;
+                        }
+                        if (pos == parent->left) {
+                            this->rotate_right(parent);
+                            parent = pos;
+                        }
+                        parent->balance = BLACK;
+                        grand->balance = RED;
+                        this->rotate_left(grand);
                     }
+                    break;
                 }
-                return false;
+                root->balance = BLACK;
+                return node;
             }
 
-            int get_rank(Node *pos, const Key &key) const {
-//                if (pos == nullptr) return 0;
-//                  int lsize = pos->left ? pos->left->size : 0;
-//                return cmp(key, pos->val.first) ? get_rank(pos->left, key) : get_rank(pos->right, key) + 1 +
-//                                                                             lsize;
+            void remove(Node *node) {
+                if (node->left && node->right) this->swap_with_successor(node);
+                Node *child = node->left ? node->left : node->right, *parent = node->parent;
+                bool black = node->balance == BLACK;
+                this->replace(parent, parent && parent->left == node, child);
+                --size;
+                this->delete_node(node);
+                if (black) fix_black(child, parent);
+            }
 
-                int rk = 0;
-                while (pos) {
-                    if (cmp(key, pos->val.first)) pos = pos->left;
-                    else {
-                        rk += 1 + (pos->left ? pos->left->size : 0);
-                        pos = pos->right;
+            /**
+             * pos (possibly nullptr, below parent) has lost a black level on its path; recolour
+             *   and rotate upwards until the levels agree again.
+             */
+            void fix_black(Node *pos, Node *parent) {
+                while (pos != root && !red(pos)) {
+                    if (pos == parent->left) {
+                        Node *sibling = parent->right;
+                        if (red(sibling)) {
+                            sibling->balance = BLACK;
+                            parent->balance = RED;
+                            this->rotate_left(parent);
+                            sibling = parent->right;
+                        }
+                        if (!red(sibling->left) && !red(sibling->right)) {
+                            sibling->balance = RED;
+                            pos = parent;
+                            parent = pos->parent;
+                            continue;
+                        }
+                        if (!red(sibling->right)) {
+                            sibling->left->balance = BLACK;
+                            sibling->balance = RED;
+                            sibling = this->rotate_right(sibling);
+                        }
+                        sibling->balance = parent->balance;
+                        parent->balance = BLACK;
+                        sibling->right->balance = BLACK;
+                        this->rotate_left(parent);
+                    } else {
+                        Node *sibling = parent->left;
+                        if (red(sibling)) {
+                            sibling->balance = BLACK;
+                            parent->balance = RED;
+                            this->rotate_right(parent);
+                            sibling = parent->left;
+                        }
+                        if (!red(sibling->left) && !red(sibling->right)) {
+                            sibling->balance = RED;
+                            pos = parent;
+                            parent = pos->parent;
+                            continue;
+                        }
+                        if (!red(sibling->left)) {
+                            sibling->right->balance = BLACK;
+                            sibling->balance = RED;
+                            sibling = this->rotate_left(sibling);
+                        }
+                        sibling->balance = parent->balance;
+                        parent->balance = BLACK;
+                        sibling->left->balance = BLACK;
+                        this->rotate_right(parent);
                     }
+                    pos = root;
                 }
-                return rk;
+                if (pos) pos->balance = BLACK;
+            }
+        };
+
+        /**
+         * an AVL tree: the heights of sibling subtrees differ by at most one, so at most
+         *   1.44 log(n + 2) levels. balance holds the height of the subtree, 1 for a leaf.
+         */
+        class Avl : public Tree {
+        public:
+            using Tree::size;
+
+            Avl(const Alloc &alloc) : Tree(alloc) {
+            }
+
+            static int height(const Node *node) {
+                return node ? node->balance : 0;
             }
 
-            Node *get_kth(const int &k) {
-                pair<Node *, Node *> x = split(root, k - 1);
-                pair<Node *, Node *> y = split(x.second, 1);
-                Node *ans = y.first;
-                root = merge(x.first, merge(ans, y.second));
-                return ans;
+            static void measure(Node *node) {
+                int l = height(node->left), r = height(node->right);
+                node->balance = (l > r ? l : r) + 1;
             }
 
-            Node *insert(const value_type &val) {
-                if (root == nullptr) {
-                    root = new Node(val);
-                    return root;
+            /**
+             * restores the balance at node, whose subtrees are balanced; returns the root of the subtree now there.
+             */
+            Node *fix(Node *node) {
+                int diff = height(node->left) - height(node->right);
+                if (diff > 1) {
+                    if (height(node->left->left) < height(node->left->right)) turn_left(node->left);
+                    return turn_right(node);
                 }
-                int k = get_rank(root, val.first);
-                pair<Node *, Node *> x(split(root, k));
-                Node *pos = new Node(val);
-                root = merge(x.first, merge(pos, x.second));
-                return pos;
+                if (diff < -1) {
+                    if (height(node->right->right) < height(node->right->left)) turn_right(node->right);
+                    return turn_left(node);
+                }
+                measure(node);
+                return node;
+            }
+
+            Node *turn_left(Node *node) {
+                Node *pivot = this->rotate_left(node);
+                measure(node);
+                measure(pivot);
+                return pivot;
+            }
+
+            Node *turn_right(Node *node) {
+                Node *pivot = this->rotate_right(node);
+                measure(node);
+                measure(pivot);
+                return pivot;
             }
 
-            void remove(const Key &key) {
-                int k = get_rank(root, key);
-                Node *node = get_kth(k);
-                pair<Node *, Node *> x = split(root, k - 1);
-                pair<Node *, Node *> y = split(x.second, 1);
-                root = merge(x.first, y.second);
-                delete node;
+            /**
+             * fixes the heights from pos up, stopping at the first subtree whose height comes out unchanged.
+             */
+            void rebalance(Node *pos) {
+                while (pos) {
+                    Node *parent = pos->parent;
+                    int before = pos->balance;
+                    if (fix(pos)->balance == before) return;
+                    pos = parent;
+                }
             }
 
-            int sze() {
-                return root ? root->size : 0;
+            template<class V>
+            Node *insert(V &&val) {
+                Node *node = this->create_node(std::forward<V>(val));
+                node->balance = 1;
+                this->link_leaf(node);
+                rebalance(node->parent);
+                return node;
+            }
+
+            void remove(Node *node) {
+                if (node->left && node->right) this->swap_with_successor(node);
+                Node *child = node->left ? node->left : node->right, *parent = node->parent;
+                this->replace(parent, parent && parent->left == node, child);
+                --size;
+                this->delete_node(node);
+                rebalance(parent);
             }
         };
+
+        /**
+         * the engine the Balance tag names.
+         */
+        typedef typename std::conditional<std::is_same<Balance, red_black>::value, RedBlack,
+                typename std::conditional<std::is_same<Balance, avl>::value, Avl, Treap>::type>::type Engine;
         /**
          * see BidirectionalIterator at CppReference for help.
          *
@@ -214,93 +647,81 @@ namespace sjtu {
          *       or it = map.end(); ++end();
          */
     private:
-        Treap *treap;
+        Engine *tree;
         Compare cmp;
+        Alloc alloc;
+
+        Engine *new_tree() {
+            return create<Engine>(alloc, alloc);
+        }
+
+        Engine *new_tree(const Engine &other) {
+            return create<Engine>(alloc, other);
+        }
+
+        void delete_tree() {
+            if (tree) dispose(alloc, tree);
+            tree = nullptr;
+        }
     public:
         class const_iterator;
 
         class iterator {
-            friend class map<Key, T, Compare>;
+            friend class map;
 
         private:
-            map<Key, T, Compare> *map_ptr;
-            Treap *treap_ptr;
+            map *map_ptr;
+            Engine *tree_ptr;
             Node *node_ptr;
             /**
              * TODO add data members
              *   just add whatever you want.
              */
         public:
-            iterator() : map_ptr(nullptr), treap_ptr(nullptr), node_ptr(nullptr) {}
+            iterator() : map_ptr(nullptr), tree_ptr(nullptr), node_ptr(nullptr) {}
 
-            iterator(const iterator &other) : map_ptr(other.map_ptr), treap_ptr(other.treap_ptr),
+            iterator(const iterator &other) : map_ptr(other.map_ptr), tree_ptr(other.tree_ptr),
                                               node_ptr(other.node_ptr) {}
 
-            iterator(map<Key, T, Compare> *map, Node *node) : map_ptr(map), treap_ptr(map->treap), node_ptr(node) {}
+            iterator(map *map, Node *node) : map_ptr(map), tree_ptr(map->tree), node_ptr(node) {}
 
             iterator &operator=(const iterator &other) {
                 if (this == &other) return *this;
                 map_ptr = other.map_ptr;
-                treap_ptr = other.treap_ptr;
+                tree_ptr = other.tree_ptr;
                 node_ptr = other.node_ptr;
                 return *this;
             }
 
             iterator operator++(int) {
-                treap_ptr = map_ptr->treap;
-                if (treap_ptr == nullptr) throw invalid_iterator();
-                if (treap_ptr->sze() == 0) throw invalid_iterator();
-                int k = treap_ptr->get_rank(treap_ptr->root, node_ptr->val.first);
-                if (treap_ptr->sze() < k) throw invalid_iterator();
                 iterator iter = *this;
-                if (treap_ptr->sze() == k) node_ptr = nullptr;
-                node_ptr = treap_ptr->get_kth(++k);
+                ++*this;
                 return iter;
             }
 
             /**
-             * TODO ++iter
+             * steps to the in-order successor along the tree links; ++end() throws.
              */
             iterator &operator++() {
-                treap_ptr = map_ptr->treap;
-                if (treap_ptr == nullptr) throw invalid_iterator();
-                if (treap_ptr->sze() == 0) throw invalid_iterator();
-                int k = treap_ptr->get_rank(treap_ptr->root, node_ptr->val.first);
-                if (treap_ptr->sze() < k) throw invalid_iterator();
-                if (treap_ptr->sze() == k) node_ptr = nullptr;
-                node_ptr = treap_ptr->get_kth(++k);
+                if (node_ptr == nullptr) throw invalid_iterator();
+                node_ptr = Tree::next(node_ptr);
                 return *this;
             }
 
-            /**
-             * TODO iter--
-             */
             iterator operator--(int) {
-                treap_ptr = map_ptr->treap;
-                if (treap_ptr == nullptr) throw invalid_iterator();
-                if (treap_ptr->sze() == 0) throw invalid_iterator();
-                if (node_ptr == nullptr) return iterator(map_ptr, treap_ptr->get_kth(treap_ptr->sze()));
-                int k = treap_ptr->get_rank(treap_ptr->root, node_ptr->val.first);
-                if (k <= 1) throw invalid_iterator();
                 iterator iter = *this;
-                node_ptr = treap_ptr->get_kth(--k);
+                --*this;
                 return iter;
             }
 
             /**
-             * TODO --iter
+             * steps to the in-order predecessor, or from end() to the last element; --begin() throws.
              */
             iterator &operator--() {
-                treap_ptr = map_ptr->treap;
-                if (treap_ptr == nullptr) throw invalid_iterator();
-                if (treap_ptr->sze() == 0) throw invalid_iterator();
-                if (node_ptr == nullptr) {
-                    node_ptr = treap_ptr->get_kth(treap_ptr->sze());
-                    return *this;
-                }
-                int k = treap_ptr->get_rank(treap_ptr->root, node_ptr->val.first);
-                if (k <= 1) throw invalid_iterator();
-                node_ptr = treap_ptr->get_kth(--k);
+                if (map_ptr == nullptr || map_ptr->tree == nullptr) throw invalid_iterator();
+                Node *node = node_ptr ? Tree::prev(node_ptr) : map_ptr->tree->last();
+                if (node == nullptr) throw invalid_iterator();
+                node_ptr = node;
                 return *this;
             }
 
@@ -348,28 +769,28 @@ namespace sjtu {
         class const_iterator {
             // it should has similar member method as iterator.
             //  and it should be able to construct from an iterator.
-            friend class map<Key, T, Compare>;
+            friend class map;
 
         private:// data members.
-            const map<Key, T, Compare> *map_ptr;
-            Treap *treap_ptr;//todo:add const
+            const map *map_ptr;
+            const Engine *tree_ptr;
             const Node *node_ptr;
         public:
-            const_iterator() : map_ptr(nullptr), treap_ptr(nullptr), node_ptr(nullptr) {}
+            const_iterator() : map_ptr(nullptr), tree_ptr(nullptr), node_ptr(nullptr) {}
 
-            const_iterator(const iterator &other) : map_ptr(other.map_ptr), treap_ptr(other.treap_ptr),
+            const_iterator(const iterator &other) : map_ptr(other.map_ptr), tree_ptr(other.tree_ptr),
                                                     node_ptr(other.node_ptr) {}
 
-            const_iterator(const const_iterator &other) : map_ptr(other.map_ptr), treap_ptr(other.treap_ptr),
+            const_iterator(const const_iterator &other) : map_ptr(other.map_ptr), tree_ptr(other.tree_ptr),
                                                           node_ptr(other.node_ptr) {}
 
-            const_iterator(const map<Key, T, Compare> *map, Node *node) : map_ptr(map), treap_ptr(map->treap),
+            const_iterator(const map *map, Node *node) : map_ptr(map), tree_ptr(map->tree),
                                                                           node_ptr(node) {}
 
             const_iterator &operator=(const const_iterator &other) {
                 if (this == &other) return *this;
                 map_ptr = other.map_ptr;
-                treap_ptr = other.treap_ptr;
+                tree_ptr = other.tree_ptr;
                 node_ptr = other.node_ptr;
                 return *this;
             }
@@ -378,60 +799,34 @@ namespace sjtu {
             // And other methods in iterator.
             // And other methods in iterator.
             const_iterator operator++(int) {
-                treap_ptr = map_ptr->treap;
-                if (treap_ptr == nullptr) throw invalid_iterator();
-                if (treap_ptr->sze() == 0) throw invalid_iterator();
-                int k = treap_ptr->get_rank(treap_ptr->root, node_ptr->val.first);
-                if (treap_ptr->sze() < k) throw invalid_iterator();
                 const_iterator iter = *this;
-                if (treap_ptr->sze() == k) node_ptr = nullptr;
-                node_ptr = treap_ptr->get_kth(++k);
+                ++*this;
                 return iter;
             }
 
             /**
-             * TODO ++iter
+             * steps to the in-order successor along the tree links; ++end() throws.
              */
             const_iterator &operator++() {
-                treap_ptr = map_ptr->treap;
-                if (treap_ptr == nullptr) throw invalid_iterator();
-                if (treap_ptr->sze() == 0) throw invalid_iterator();
-                int k = treap_ptr->get_rank(treap_ptr->root, node_ptr->val.first);
-                if (treap_ptr->sze() < k) throw invalid_iterator();
-                if (treap_ptr->sze() == k) node_ptr = nullptr;
-                node_ptr = treap_ptr->get_kth(++k);
+                if (node_ptr == nullptr) throw invalid_iterator();
+                node_ptr = Tree::next(node_ptr);
                 return *this;
             }
 
-            /**
-             * TODO iter--
-             */
             const_iterator operator--(int) {
-                treap_ptr = map_ptr->treap;
-                if (treap_ptr == nullptr) throw invalid_iterator();
-                if (treap_ptr->sze() == 0) throw invalid_iterator();
-                if (node_ptr == nullptr) return const_iterator(map_ptr, treap_ptr->get_kth(treap_ptr->sze()));
-                int k = treap_ptr->get_rank(treap_ptr->root, node_ptr->val.first);
-                if (k == 1) throw invalid_iterator();
                 const_iterator iter = *this;
-                node_ptr = treap_ptr->get_kth(--k);
+                --*this;
                 return iter;
             }
 
             /**
-             * TODO --iter
+             * steps to the in-order predecessor, or from end() to the last element; --begin() throws.
              */
             const_iterator &operator--() {
-                treap_ptr = map_ptr->treap;
-                if (treap_ptr == nullptr) throw invalid_iterator();
-                if (treap_ptr->sze() == 0) throw invalid_iterator();
-                if (node_ptr == nullptr) {
-                    node_ptr = treap_ptr->get_kth(treap_ptr->sze());
-                    return *this;
-                }
-                int k = treap_ptr->get_rank(treap_ptr->root, node_ptr->val.first);
-                if (k == 1) throw invalid_iterator();
-                node_ptr = treap_ptr->get_kth(--k);
+                if (map_ptr == nullptr || map_ptr->tree == nullptr) throw invalid_iterator();
+                Node *node = node_ptr ? Tree::prev(node_ptr) : map_ptr->tree->last();
+                if (node == nullptr) throw invalid_iterator();
+                node_ptr = node;
                 return *this;
             }
 
@@ -445,14 +840,14 @@ namespace sjtu {
 
             bool operator==(const iterator &rhs) const {
                 if (map_ptr != rhs.map_ptr) return false;
-                if (treap_ptr != rhs.treap_ptr) return false;
+                if (tree_ptr != rhs.tree_ptr) return false;
                 if (node_ptr != rhs.node_ptr) return false;
                 return true;
             }
 
             bool operator==(const const_iterator &rhs) const {
                 if (map_ptr != rhs.map_ptr) return false;
-                if (treap_ptr != rhs.treap_ptr) return false;
+                if (tree_ptr != rhs.tree_ptr) return false;
                 if (node_ptr != rhs.node_ptr) return false;
                 return true;
             }
@@ -482,28 +877,63 @@ namespace sjtu {
         /**
          * TODO two constructors
          */
-        map() : treap(nullptr) {
-            treap = new Treap;
+        map() : tree(nullptr), alloc() {
+            tree = new_tree();
+        }
+
+        /**
+         * an empty map drawing its nodes from alloc.
+         */
+        explicit map(const Alloc &alloc) : tree(nullptr), alloc(alloc) {
+            tree = new_tree();
+        }
+
+        map(const map &other) : tree(nullptr), alloc(other.alloc) {
+            tree = other.tree ? new_tree(*(other.tree)) : new_tree();
         }
 
-        map(const map &other) : treap(nullptr) {
-            treap = new Treap(*(other.treap));
+        /**
+         * takes over the nodes of other, leaving it empty. O(1).
+         */
+        map(map &&other) noexcept : tree(other.tree), cmp(other.cmp), alloc(other.alloc) {
+            other.tree = nullptr;
         }
 
         map &operator=(const map &other) {
             if (this == &other) return *this;
-            if (treap) delete treap;
-            treap = new Treap(*(other.treap));
+            delete_tree();
+            tree = other.tree ? new_tree(*(other.tree)) : new_tree();
+            return *this;
+        }
+
+        /**
+         * the allocator travels with the nodes.
+         */
+        map &operator=(map &&other) noexcept {
+            if (this == &other) return *this;
+            delete_tree();
+            tree = other.tree;
+            cmp = other.cmp;
+            alloc = other.alloc;
+            other.tree = nullptr;
             return *this;
         }
 
+        /**
+         * exchanges the contents (and allocators) of the two maps in O(1).
+         * iterators of both maps are invalidated.
+         */
+        void swap(map &other) noexcept {
+            std::swap(tree, other.tree);
+            std::swap(cmp, other.cmp);
+            std::swap(alloc, other.alloc);
+        }
+
         /**
          * TODO Destructors
          */
         ~map() {
-            if (treap)
-//                treap->clear(treap->root);
-                delete treap;
+            delete_tree();
         }
 
         /**
@@ -513,17 +943,17 @@ namespace sjtu {
          * If no such element exists, an exception of type `index_out_of_bound'
          */
         T &at(const Key &key) {
-            if (!treap) throw container_is_empty();
-            if (!treap->exist(treap->root, key)) throw index_out_of_bound();
-            int k = treap->get_rank(treap->root, key);
-            return treap->get_kth(k)->val.second;
+            if (!tree) throw container_is_empty();
+            Node *node = tree->find(key);
+            if (!node) throw index_out_of_bound();
+            return node->val.second;
         }
 
         const T &at(const Key &key) const {
-            if (!treap) throw container_is_empty();
-            if (!treap->exist(treap->root, key)) throw index_out_of_bound();
-            int k = treap->get_rank(treap->root, key);
-            return treap->get_kth(k)->val.second;
+            if (!tree) throw container_is_empty();
+            Node *node = tree->find(key);
+            if (!node) throw index_out_of_bound();
+            return node->val.second;
         }
 
         /**
@@ -531,40 +961,33 @@ namespace sjtu {
          * access specified element
          * Returns a reference to the value that is mapped to a key equivalent to key,
          *   performing an insertion if such key does not already exist.
+         * a hit is one descent; a miss is one more, down to where the new node goes.
          */
         T &operator[](const Key &key) {
-            if (!treap) {
-                treap = new Treap;
-                treap->insert(value_type(key, T()));
-            }
-            if (!treap->exist(treap->root, key)) {
-                treap->insert(value_type(key, T()));
-            }
-            int k = treap->get_rank(treap->root, key);
-            return treap->get_kth(k)->val.second;
+            if (!tree) tree = new_tree();
+            Node *node = tree->find(key);
+            if (!node) node = tree->insert(value_type(key, T()));
+            return node->val.second;
         }
 
         /**
          * behave like at() throw index_out_of_bound if such key does not exist.
          */
         const T &operator[](const Key &key) const {
-            if (!treap) throw container_is_empty();
-            if (!treap->exist(treap->root, key)) throw index_out_of_bound();
-            int k = treap->get_rank(treap->root, key);
-            return treap->get_kth(k)->val.second;
+            return at(key);
         }
 
         /**
          * return a iterator to the beginning
          */
         iterator begin() {
-            if (treap == nullptr) return iterator(this, nullptr);
-            return iterator(this, treap->get_kth(1));
+            if (tree == nullptr) return iterator(this, nullptr);
+            return iterator(this, tree->first());
         }
 
         const_iterator cbegin() const {
-            if (treap == nullptr) return const_iterator(this, nullptr);
-            return const_iterator(this, treap->get_kth(1));
+            if (tree == nullptr) return const_iterator(this, nullptr);
+            return const_iterator(this, tree->first());
         }
 
         /**
@@ -592,17 +1015,14 @@ namespace sjtu {
          * returns the number of elements.
          */
         size_t size() const {
-            return treap ? treap->sze() : 0;
+            return tree ? tree->sze() : 0;
         }
 
         /**
          * clears the contents
          */
         void clear() {
-            if (treap)
-//                treap->clear(treap->root);
-                delete treap;
-            treap = nullptr;
+            delete_tree();
         }
 
         /**
@@ -612,10 +1032,25 @@ namespace sjtu {
          *   the second one is true if insert successfully, or false.
          */
         pair<iterator, bool> insert(const value_type &value) {
-            if (!treap) treap = new Treap;
-            iterator iter = find(value.first);
-            if (iter == end()) return pair<iterator, bool>(iterator(this, treap->insert(value)), true);
-            return pair<iterator, bool>(iter, false);
+            if (!tree) tree = new_tree();
+            Node *node = tree->find(value.first);
+            if (node) return pair<iterator, bool>(iterator(this, node), false);
+            return pair<iterator, bool>(iterator(this, tree->insert(value)), true);
+        }
+
+        pair<iterator, bool> insert(value_type &&value) {
+            if (!tree) tree = new_tree();
+            Node *node = tree->find(value.first);
+            if (node) return pair<iterator, bool>(iterator(this, node), false);
+            return pair<iterator, bool>(iterator(this, tree->insert(std::move(value))), true);
+        }
+
+        /**
+         * builds an element from args and inserts it, as insert(value) does.
+         */
+        template<class... Args>
+        pair<iterator, bool> emplace(Args &&... args) {
+            return insert(value_type(std::forward<Args>(args)...));
         }
 
         /**
@@ -625,10 +1060,10 @@ namespace sjtu {
          */
         void erase(iterator pos) {
             if (pos == end()) throw invalid_iterator();
-            if (pos.treap_ptr != treap) throw invalid_iterator();
+            if (pos.tree_ptr != tree) throw invalid_iterator();
             if (pos.node_ptr == nullptr) throw invalid_iterator();
-            if (end() == find(pos.node_ptr->val.first)) throw invalid_iterator();
-            treap->remove(pos.node_ptr->val.first);
+            if (tree->find(pos.node_ptr->val.first) != pos.node_ptr) throw invalid_iterator();
+            tree->remove(pos.node_ptr);
         }
 
         /**
@@ -650,25 +1085,22 @@ namespace sjtu {
          *   If no such element is found, past-the-end (see end()) iterator is returned.
          */
         iterator find(const Key &key) {
-            if (treap == nullptr) return end();
-            if (treap->exist(treap->root, key)) {
-                int k = treap->get_rank(treap->root, key);
-                return iterator(this, treap->get_kth(k));
-            }
-            return end();
+            if (tree == nullptr) return end();
+            return iterator(this, tree->find(key));
         }
 
         const_iterator find(const Key &key) const {
-            if (treap == nullptr) return cend();
-            if (treap->exist(treap->root, key)) {
-                int k = treap->get_rank(treap->root, key);
-                return const_iterator(this, treap->get_kth(k));
-            }
-            return cend();
+            if (tree == nullptr) return cend();
+            return const_iterator(this, tree->find(key));
         }
 
     };
 
+    template<class Key, class T, class Compare, class Alloc, class Balance>
+    void swap(map<Key, T, Compare, Alloc, Balance> &lhs, map<Key, T, Compare, Alloc, Balance> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,402 @@
+#ifndef SJTU_ALLOCATOR_HPP
+#define SJTU_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+
+/**
+ * allocators accepted by the containers, in the shape std::allocator_traits expects:
+ *   value_type, allocate(n), deallocate(p, n), a converting constructor for rebinding, == and !=.
+ * the stateful ones only hold a pointer to their resource (arena or pool),
+ *   so every copy and rebind of an allocator draws from the same resource.
+ */
+
+/**
+ * the default: ::operator new / ::operator delete.
+ */
+    template<class T>
+    class allocator {
+    public:
+        typedef T value_type;
+
+        allocator() {}
+
+        template<class U>
+        allocator(const allocator<U> &) {}
+
+        T *allocate(size_t n) {
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T *p, size_t) {
+            ::operator delete(p);
+        }
+    };
+
+    template<class T, class U>
+    bool operator==(const allocator<T> &, const allocator<U> &) {
+        return true;
+    }
+
+    template<class T, class U>
+    bool operator!=(const allocator<T> &, const allocator<U> &) {
+        return false;
+    }
+
+/**
+ * std::malloc / std::free, for linking against a replacement malloc.
+ */
+    template<class T>
+    class malloc_allocator {
+    public:
+        typedef T value_type;
+
+        malloc_allocator() {}
+
+        template<class U>
+        malloc_allocator(const malloc_allocator<U> &) {}
+
+        T *allocate(size_t n) {
+            void *p = std::malloc(n * sizeof(T));
+            if (p == nullptr) throw std::bad_alloc();
+            return static_cast<T *>(p);
+        }
+
+        void deallocate(T *p, size_t) {
+            std::free(p);
+        }
+    };
+
+    template<class T, class U>
+    bool operator==(const malloc_allocator<T> &, const malloc_allocator<U> &) {
+        return true;
+    }
+
+    template<class T, class U>
+    bool operator!=(const malloc_allocator<T> &, const malloc_allocator<U> &) {
+        return false;
+    }
+
+/**
+ * a monotonic arena: allocation bumps a pointer through big chunks, deallocation does nothing,
+ *   and every chunk is given back at once by release() or the destructor.
+ * containers using it must not outlive it.
+ */
+    class arena {
+    private:
+        struct Chunk {
+            Chunk *nxt;
+        };
+
+        Chunk *head;
+        char *cur, *end;
+        size_t chunk_size;
+
+        static size_t header() {
+            return (sizeof(Chunk) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+        }
+
+        char *new_chunk(size_t bytes) {
+            Chunk *chunk = static_cast<Chunk *>(::operator new(header() + bytes));
+            chunk->nxt = head;
+            head = chunk;
+            return reinterpret_cast<char *>(chunk) + header();
+        }
+
+    public:
+        explicit arena(size_t chunk_size = 1 << 16) : head(nullptr), cur(nullptr), end(nullptr),
+                                                      chunk_size(chunk_size) {}
+
+        arena(const arena &) = delete;
+
+        arena &operator=(const arena &) = delete;
+
+        ~arena() {
+            release();
+        }
+
+        void *allocate(size_t bytes, size_t align) {
+            size_t pad = (align - reinterpret_cast<size_t>(cur) % align) % align;
+            if (cur == nullptr || pad + bytes > size_t(end - cur)) {
+                if (bytes + align > chunk_size) {
+                    // oversized requests get a chunk of their own and leave the current one alone
+                    char *p = new_chunk(bytes + align);
+                    return p + (align - reinterpret_cast<size_t>(p) % align) % align;
+                }
+                cur = new_chunk(chunk_size);
+                end = cur + chunk_size;
+                pad = (align - reinterpret_cast<size_t>(cur) % align) % align;
+            }
+            char *p = cur + pad;
+            cur = p + bytes;
+            return p;
+        }
+
+        /**
+         * frees every chunk; everything allocated from the arena becomes invalid.
+         */
+        void release() {
+            while (head) {
+                Chunk *nxt = head->nxt;
+                ::operator delete(head);
+                head = nxt;
+            }
+            cur = end = nullptr;
+        }
+    };
+
+    template<class T>
+    class arena_allocator {
+        template<class U>
+        friend class arena_allocator;
+
+    private:
+        arena *resource;
+
+    public:
+        typedef T value_type;
+
+        arena_allocator(arena &resource) : resource(&resource) {}
+
+        template<class U>
+        arena_allocator(const arena_allocator<U> &other) : resource(other.resource) {}
+
+        T *allocate(size_t n) {
+            return static_cast<T *>(resource->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *, size_t) {}
+
+        template<class U>
+        bool operator==(const arena_allocator<U> &rhs) const {
+            return resource == rhs.resource;
+        }
+
+        template<class U>
+        bool operator!=(const arena_allocator<U> &rhs) const {
+            return resource != rhs.resource;
+        }
+    };
+
+/**
+ * a pool of fixed-size blocks: a request is rounded up to a size class of GRAIN bytes,
+ *   each class keeps a free list refilled from big chunks, and deallocated blocks go back on the list.
+ * requests above MAX_BLOCK bytes or with unusual alignment go straight to ::operator new.
+ * chunks are given back by release() or the destructor.
+ */
+    class pool {
+    private:
+        static const size_t GRAIN = alignof(std::max_align_t);
+        static const size_t MAX_BLOCK = 512;
+        static const size_t CLASSES = MAX_BLOCK / GRAIN;
+
+        struct Free {
+            Free *nxt;
+        };
+
+        struct Chunk {
+            Chunk *nxt;
+        };
+
+        Free *free_list[CLASSES];
+        Chunk *head;
+        size_t chunk_size;
+
+        void refill(size_t cls) {
+            size_t block = (cls + 1) * GRAIN;
+            size_t num = chunk_size / block;
+            if (num == 0) num = 1;
+            Chunk *chunk = static_cast<Chunk *>(::operator new(GRAIN + num * block));
+            chunk->nxt = head;
+            head = chunk;
+            char *p = reinterpret_cast<char *>(chunk) + GRAIN;
+            for (size_t i = 0; i < num; ++i, p += block) {
+                Free *f = reinterpret_cast<Free *>(p);
+                f->nxt = free_list[cls];
+                free_list[cls] = f;
+            }
+        }
+
+        static bool pooled(size_t bytes, size_t align) {
+            return bytes != 0 && bytes <= MAX_BLOCK && align <= GRAIN;
+        }
+
+    public:
+        explicit pool(size_t chunk_size = 1 << 16) : head(nullptr), chunk_size(chunk_size) {
+            for (size_t i = 0; i < CLASSES; ++i) free_list[i] = nullptr;
+        }
+
+        pool(const pool &) = delete;
+
+        pool &operator=(const pool &) = delete;
+
+        ~pool() {
+            release();
+        }
+
+        void *allocate(size_t bytes, size_t align) {
+            if (!pooled(bytes, align)) return ::operator new(bytes);
+            size_t cls = (bytes - 1) / GRAIN;
+            if (free_list[cls] == nullptr) refill(cls);
+            Free *f = free_list[cls];
+            free_list[cls] = f->nxt;
+            return f;
+        }
+
+        void deallocate(void *p, size_t bytes, size_t align) {
+            if (!pooled(bytes, align)) {
+                ::operator delete(p);
+                return;
+            }
+            size_t cls = (bytes - 1) / GRAIN;
+            Free *f = static_cast<Free *>(p);
+            f->nxt = free_list[cls];
+            free_list[cls] = f;
+        }
+
+        /**
+         * frees every chunk; everything allocated from the pool becomes invalid.
+         */
+        void release() {
+            while (head) {
+                Chunk *nxt = head->nxt;
+                ::operator delete(head);
+                head = nxt;
+            }
+            for (size_t i = 0; i < CLASSES; ++i) free_list[i] = nullptr;
+        }
+    };
+
+    template<class T>
+    class pool_allocator {
+        template<class U>
+        friend class pool_allocator;
+
+    private:
+        pool *resource;
+
+    public:
+        typedef T value_type;
+
+        pool_allocator(pool &resource) : resource(&resource) {}
+
+        template<class U>
+        pool_allocator(const pool_allocator<U> &other) : resource(other.resource) {}
+
+        T *allocate(size_t n) {
+            return static_cast<T *>(resource->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *p, size_t n) {
+            resource->deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        template<class U>
+        bool operator==(const pool_allocator<U> &rhs) const {
+            return resource == rhs.resource;
+        }
+
+        template<class U>
+        bool operator!=(const pool_allocator<U> &rhs) const {
+            return resource != rhs.resource;
+        }
+    };
+
+/**
+ * a per-container free list of fixed-size slots for one node type U, carved out of slabs of SLAB slots
+ *   which are taken from Alloc (rebound to the slab type).
+ * deallocate() puts a slot back on the free list for the next allocate(); slabs are only given back,
+ *   all at once, by release() or the destructor, after the owner has destroyed every live object.
+ */
+    template<class U, class Alloc, size_t SLAB = 64>
+    class slab_pool {
+    private:
+        union Slot {
+            Slot *nxt;
+            typename std::aligned_storage<sizeof(U), alignof(U)>::type storage;
+        };
+
+        struct Slab {
+            Slab *nxt;
+            Slot slots[SLAB];
+        };
+
+        typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Slab> slab_allocator;
+        typedef std::allocator_traits<slab_allocator> slab_traits;
+
+        slab_allocator alloc;
+        Slab *slabs;
+        Slot *free_slot;
+
+        void refill() {
+            Slab *slab = slab_traits::allocate(alloc, 1);
+            slab->nxt = slabs;
+            slabs = slab;
+            for (size_t i = SLAB; i > 0; --i) {
+                slab->slots[i - 1].nxt = free_slot;
+                free_slot = &slab->slots[i - 1];
+            }
+        }
+
+    public:
+        explicit slab_pool(const Alloc &alloc) : alloc(alloc), slabs(nullptr), free_slot(nullptr) {}
+
+        slab_pool(const slab_pool &) = delete;
+
+        slab_pool &operator=(const slab_pool &) = delete;
+
+        ~slab_pool() {
+            release();
+        }
+
+        /**
+         * raw storage for one U; construct it with placement new.
+         */
+        U *allocate() {
+            if (free_slot == nullptr) refill();
+            Slot *slot = free_slot;
+            free_slot = slot->nxt;
+            return reinterpret_cast<U *>(slot);
+        }
+
+        /**
+         * takes back the storage of an already destroyed U.
+         */
+        void deallocate(U *p) {
+            Slot *slot = reinterpret_cast<Slot *>(p);
+            slot->nxt = free_slot;
+            free_slot = slot;
+        }
+
+        /**
+         * gives every slab back to the allocator; all slots become invalid.
+         */
+        void release() {
+            while (slabs) {
+                Slab *nxt = slabs->nxt;
+                slab_traits::deallocate(alloc, slabs, 1);
+                slabs = nxt;
+            }
+            free_slot = nullptr;
+        }
+
+        /**
+         * exchanges the slabs and free lists (and allocators) of two pools, so a container can hand
+         *   its nodes to another in O(1).
+         */
+        void swap(slab_pool &other) noexcept {
+            std::swap(alloc, other.alloc);
+            std::swap(slabs, other.slabs);
+            std::swap(free_slot, other.free_slot);
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <string>
+
+#include "priority_queue.hpp"
+
+/**
+ * a comparator whose order is fixed when it is constructed, so that copies of a queue must carry it along.
+ */
+bool descending = false;
+
+struct Order {
+	bool desc;
+	Order() : desc(descending) {}
+	bool operator()(int a, int b) const {
+		return desc ? b < a : a < b;
+	}
+};
+
+template<class Queue>
+void Drain(Queue &q)
+{
+	while (!q.empty()) {
+		std::cout << q.top() << " ";
+		q.pop();
+	}
+	std::cout << std::endl;
+}
+
+void TestPool()
+{
+	std::cout << "Testing priority_queue on a pool_allocator..." << std::endl;
+	sjtu::pool pool;
+	typedef sjtu::priority_queue<std::string, std::less<std::string>, sjtu::pool_allocator<std::string>> Queue;
+	sjtu::pool_allocator<std::string> alloc(pool);
+	Queue a(alloc), b(alloc);
+	for (int i = 0; i < 20000; ++i) {
+		a.push(std::to_string(i * 7 % 20000));
+		if (i % 4 == 0) a.pop();
+	}
+	for (int i = 0; i < 1000; ++i) {
+		b.push(std::to_string(i));
+	}
+	Queue c(a);
+	a.merge(b);
+	std::cout << a.size() << " " << b.size() << " " << c.size() << " " << a.top() << std::endl;
+	int bad = 0;
+	std::string prev = a.top();
+	while (!a.empty()) {
+		if (prev < a.top()) ++bad;
+		prev = a.top();
+		a.pop();
+	}
+	c = c;
+	b = c;
+	for (int i = 0; i < 5; ++i) {
+		b.pop();
+	}
+	std::cout << bad << " " << b.size() << " " << b.top() << " " << c.top() << std::endl;
+}
+
+void TestArena()
+{
+	std::cout << "Testing priority_queue on an arena_allocator..." << std::endl;
+	sjtu::arena arena(1 << 12);
+	typedef sjtu::priority_queue<int, Order, sjtu::arena_allocator<int>> Queue;
+	sjtu::arena_allocator<int> alloc(arena);
+	descending = true;
+	Queue min_first(alloc);
+	descending = false;
+	Queue max_first(alloc);
+	for (int i = 0; i < 10; ++i) {
+		min_first.push(i * 3 % 10);
+		max_first.push(i * 7 % 10);
+	}
+	Queue copy(alloc);
+	copy = min_first;
+	Drain(copy);
+	copy = max_first;
+	Drain(copy);
+	Queue moved(std::move(min_first));
+	moved.push(-1);
+	moved.swap(max_first);
+	Drain(moved);
+	Drain(max_first);
+	std::cout << min_first.size() << std::endl;
+}
+
+int main()
+{
+	TestPool();
+	TestArena();
+	return 0;
+}
@@ -3,43 +3,215 @@
 
 #include <cstddef>
 #include <functional>
+#include <memory>
+#include <new>
+#include <utility>
 #include "exceptions.hpp"
+#include "allocator.hpp"
 
 namespace sjtu {
 
 /**
  * a container like std::priority_queue which is a heap internal.
+ * implemented as a leftist heap, so merge costs O(log n).
  */
-template<typename T, class Compare = std::less<T>>
+template<typename T, class Compare = std::less<T>, class Alloc = allocator<T>>
 class priority_queue {
+private:
+	class Node {
+	public:
+		T data;
+		Node *left, *right;
+		int dist;
+
+		template<class... Args>
+		Node(Args &&... args) : data(std::forward<Args>(args)...), left(nullptr), right(nullptr), dist(0) {}
+	};
+
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Node> node_allocator;
+	typedef std::allocator_traits<node_allocator> node_traits;
+
+	Node *root;
+	size_t num;
+	Compare cmp;
+	node_allocator alloc;
+
+	template<class... Args>
+	Node *new_node(Args &&... args) {
+		Node *node = node_traits::allocate(alloc, 1);
+		try {
+			new(node) Node(std::forward<Args>(args)...);
+		} catch (...) {
+			node_traits::deallocate(alloc, node, 1);
+			throw;
+		}
+		return node;
+	}
+
+	void delete_node(Node *node) {
+		node->~Node();
+		node_traits::deallocate(alloc, node, 1);
+	}
+
+	static int dist(Node *node) {
+		return node ? node->dist : -1;
+	}
+
+	/**
+	 * merge two heaps along their right spines, O(log n).
+	 */
+	Node *merge(Node *a, Node *b) {
+		if (!a) return b;
+		if (!b) return a;
+		if (cmp(a->data, b->data)) {
+			Node *tmp = a;
+			a = b;
+			b = tmp;
+		}
+		a->right = merge(a->right, b);
+		if (dist(a->left) < dist(a->right)) {
+			Node *tmp = a->left;
+			a->left = a->right;
+			a->right = tmp;
+		}
+		a->dist = dist(a->right) + 1;
+		return a;
+	}
+
+	/**
+	 * the left spine of a leftist heap can be as long as the heap, so it is walked iteratively.
+	 */
+	Node *copy(Node *other) {
+		Node *res = nullptr, **slot = &res;
+		try {
+			for (; other; other = other->left) {
+				Node *node = new_node(other->data);
+				node->dist = other->dist;
+				*slot = node;
+				slot = &node->left;
+				node->right = copy(other->right);
+			}
+		} catch (...) {
+			clear(res);
+			throw;
+		}
+		return res;
+	}
+
+	/**
+	 * rotate left children up until there is none, then drop the node: O(n) without recursion.
+	 */
+	void clear(Node *node) {
+		while (node) {
+			if (node->left) {
+				Node *left = node->left;
+				node->left = left->right;
+				left->right = node;
+				node = left;
+			} else {
+				Node *right = node->right;
+				delete_node(node);
+				node = right;
+			}
+		}
+	}
+
 public:
 	/**
 	 * TODO constructors
 	 */
-	priority_queue() {}
-	priority_queue(const priority_queue &other) {}
+	priority_queue() : root(nullptr), num(0), cmp(), alloc() {}
+
+	/**
+	 * an empty queue drawing its nodes from alloc.
+	 */
+	explicit priority_queue(const Alloc &alloc) : root(nullptr), num(0), cmp(), alloc(alloc) {}
+
+	priority_queue(const priority_queue &other) : root(nullptr), num(other.num), cmp(other.cmp),
+	                                              alloc(other.alloc) {
+		root = copy(other.root);
+	}
+
+	/**
+	 * takes over the heap of other, leaving it empty. O(1).
+	 */
+	priority_queue(priority_queue &&other) noexcept : root(other.root), num(other.num), cmp(other.cmp),
+	                                                  alloc(other.alloc) {
+		other.root = nullptr;
+		other.num = 0;
+	}
 	/**
 	 * TODO deconstructor
 	 */
-	~priority_queue() {}
+	~priority_queue() {
+		clear(root);
+	}
 	/**
 	 * TODO Assignment operator
 	 */
-	priority_queue &operator=(const priority_queue &other) {}
+	priority_queue &operator=(const priority_queue &other) {
+		if (this == &other) return *this;
+		Node *tmp = copy(other.root);
+		clear(root);
+		root = tmp;
+		num = other.num;
+		cmp = other.cmp;
+		return *this;
+	}
+
+	/**
+	 * the allocator travels with the nodes.
+	 */
+	priority_queue &operator=(priority_queue &&other) noexcept {
+		if (this == &other) return *this;
+		clear(root);
+		root = other.root;
+		num = other.num;
+		cmp = other.cmp;
+		alloc = other.alloc;
+		other.root = nullptr;
+		other.num = 0;
+		return *this;
+	}
+
+	/**
+	 * exchanges the contents (and allocators) of the two queues in O(1).
+	 */
+	void swap(priority_queue &other) noexcept {
+		std::swap(root, other.root);
+		std::swap(num, other.num);
+		std::swap(cmp, other.cmp);
+		std::swap(alloc, other.alloc);
+	}
 	/**
 	 * get the top of the queue.
 	 * @return a reference of the top element.
 	 * throw container_is_empty if empty() returns true;
 	 */
 	const T & top() const {
-
+		if (empty()) throw container_is_empty();
+		return root->data;
 	}
 	/**
 	 * TODO
 	 * push new element to the priority queue.
 	 */
 	void push(const T &e) {
+		emplace(e);
+	}
 
+	void push(T &&e) {
+		emplace(std::move(e));
+	}
+
+	/**
+	 * constructs an element from args and pushes it.
+	 */
+	template<class... Args>
+	void emplace(Args &&... args) {
+		Node *node = new_node(std::forward<Args>(args)...);
+		root = merge(root, node);
+		++num;
 	}
 	/**
 	 * TODO
@@ -47,28 +219,50 @@ public:
 	 * throw container_is_empty if empty() returns true;
 	 */
 	void pop() {
-
+		if (empty()) throw container_is_empty();
+		Node *old = root;
+		root = merge(root->left, root->right);
+		delete_node(old);
+		--num;
 	}
 	/**
 	 * return the number of the elements.
 	 */
 	size_t size() const {
-
+		return num;
 	}
 	/**
 	 * check if the container has at least an element.
 	 * @return true if it is empty, false if it has at least an element.
 	 */
 	bool empty() const {
-
+		return num == 0;
 	}
 	/**
 	 * return a merged priority_queue with at least O(logn) complexity.
+	 * other is left empty. if the two queues use unequal allocators
+	 *   the nodes of other are copied instead, which costs O(n).
 	 */
 	void merge(priority_queue &other) {
+		if (this == &other) return;
+		if (alloc != other.alloc) {
+			Node *tmp = copy(other.root);
+			other.clear(other.root);
+			root = merge(root, tmp);
+		} else {
+			root = merge(root, other.root);
+		}
+		num += other.num;
+		other.root = nullptr;
+		other.num = 0;
 	}
 };
 
+template<typename T, class Compare, class Alloc>
+void swap(priority_queue<T, Compare, Alloc> &lhs, priority_queue<T, Compare, Alloc> &rhs) noexcept {
+	lhs.swap(rhs);
+}
+
 }
 
 #endif
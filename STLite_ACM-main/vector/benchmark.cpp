@@ -0,0 +1,68 @@
+#include "vector.hpp"
+
+#include <cstdio>
+#include <ctime>
+
+/**
+ * compares the memcpy/memmove relocation path (trivially copyable int)
+ *   against the element-wise path (an int wrapper with a user-provided copy constructor).
+ */
+struct Boxed {
+    int x;
+
+    Boxed(int x) : x(x) {}
+
+    Boxed(const Boxed &other) : x(other.x) {}
+
+    Boxed &operator=(const Boxed &other) {
+        x = other.x;
+        return *this;
+    }
+};
+
+const int PUSH_N = 10000000;
+const int INSERT_N = 100;
+
+double elapsed(clock_t from) {
+    return double(clock() - from) / CLOCKS_PER_SEC;
+}
+
+template<class T>
+double BenchPushBack(long long &checksum) {
+    clock_t from = clock();
+    sjtu::vector<T> v;
+    for (int i = 0; i < PUSH_N; ++i) v.push_back(T(i));
+    sjtu::vector<T> copy(v);
+    checksum += *reinterpret_cast<const int *>(&copy[PUSH_N / 2]);
+    return elapsed(from);
+}
+
+template<class T>
+double BenchMiddleInsert(long long &checksum) {
+    sjtu::vector<T> v;
+    v.reserve(PUSH_N + INSERT_N);
+    for (int i = 0; i < PUSH_N; ++i) v.push_back(T(i));
+    clock_t from = clock();
+    for (int i = 0; i < INSERT_N; ++i) v.insert(v.size() / 2, T(i));
+    for (int i = 0; i < INSERT_N; ++i) v.erase(v.size() / 2);
+    checksum += *reinterpret_cast<const int *>(&v[PUSH_N / 2]);
+    return elapsed(from);
+}
+
+int main() {
+    long long checksum = 0;
+    double fast, slow;
+
+    fast = BenchPushBack<int>(checksum);
+    slow = BenchPushBack<Boxed>(checksum);
+    printf("push_back + copy, %d elements: memcpy %.3fs, element-wise %.3fs, x%.1f\n", PUSH_N, fast, slow,
+           slow / fast);
+
+    fast = BenchMiddleInsert<int>(checksum);
+    slow = BenchMiddleInsert<Boxed>(checksum);
+    printf("%d middle insert + erase on %d elements: memmove %.3fs, element-wise %.3fs, x%.1f\n", INSERT_N, PUSH_N,
+           fast, slow, slow / fast);
+
+    printf("checksum %lld\n", checksum);
+    return 0;
+}
@@ -0,0 +1,298 @@
+#ifndef SJTU_CONTIGUOUS_HPP
+#define SJTU_CONTIGUOUS_HPP
+
+#include "exceptions.hpp"
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+    template<typename T, class Container>
+    class contiguous_const_iterator;
+
+/**
+ * the iterator of the containers that keep their elements in one array, [start, finish):
+ *   vector and inline_vector (small_vector, static_vector).
+ * it is a pointer into that array together with the container, which must befriend it
+ *   (dereferencing checks the pointer against the container's [start, finish)).
+ * you can see RandomAccessIterator at CppReference for help.
+ */
+    template<typename T, class Container>
+    class contiguous_iterator {
+        friend Container;
+        friend class contiguous_const_iterator<T, Container>;
+    private:
+        const Container *loc;
+
+        T *iter;
+    public:
+        contiguous_iterator(const contiguous_iterator &other) : loc(other.loc), iter(other.iter) {}
+
+        contiguous_iterator(Container *vec = nullptr, T *it = nullptr) : loc(vec), iter(it) {}
+
+        /**
+         * return a new iterator which pointer n-next elements
+         * as well as operator-
+         */
+        contiguous_iterator operator+(const int &n) const {
+            contiguous_iterator tmp = *this;
+            tmp.iter += n;
+            return tmp;
+        }
+
+        contiguous_iterator operator-(const int &n) const {
+            contiguous_iterator tmp = *this;
+            tmp.iter -= n;
+            return tmp;
+        }
+
+        // return the distance between two iterators,
+        // if these two iterators point to different vectors, throw invalid_iterator.
+        int operator-(const contiguous_iterator &rhs) const {
+            if (rhs.loc != this->loc) throw invalid_iterator();
+            return this->iter - rhs.iter;
+        }
+
+        contiguous_iterator &operator+=(const int &n) {
+            this->iter += n;
+            return *this;
+        }
+
+        contiguous_iterator &operator-=(const int &n) {
+            this->iter -= n;
+            return *this;
+        }
+
+        contiguous_iterator operator++(int) {
+            contiguous_iterator tmp = *this;
+            (*this) += 1;
+            return tmp;
+        }
+
+        contiguous_iterator &operator++() {
+            return (*this) += 1;
+        }
+
+        contiguous_iterator operator--(int) {
+            contiguous_iterator tmp = *this;
+            (*this) -= 1;
+            return tmp;
+        }
+
+        contiguous_iterator &operator--() {
+            return (*this) -= 1;
+        }
+
+        T &operator*() const {
+            if (loc == nullptr || iter < loc->start || iter >= loc->finish) throw invalid_iterator();
+            return *iter;
+        }
+
+        T *operator->() const {
+            if (loc == nullptr || iter < loc->start || iter >= loc->finish) throw invalid_iterator();
+            return iter;
+        }
+
+        bool operator==(const contiguous_iterator &rhs) const {
+            return (loc == rhs.loc) && (iter == rhs.iter);
+        }
+
+        bool operator==(const contiguous_const_iterator<T, Container> &rhs) const {
+            return (loc == rhs.loc) && (iter == rhs.iter);
+        }
+
+        bool operator!=(const contiguous_iterator &rhs) const {
+            return !(*this == rhs);
+        }
+
+        bool operator!=(const contiguous_const_iterator<T, Container> &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+
+/**
+ * has same function as contiguous_iterator, just for a const object.
+ */
+    template<typename T, class Container>
+    class contiguous_const_iterator {
+        friend Container;
+        friend class contiguous_iterator<T, Container>;
+    private:
+        const Container *loc;
+
+        const T *iter;
+    public:
+        contiguous_const_iterator(const contiguous_const_iterator &other) : loc(other.loc), iter(other.iter) {}
+
+        contiguous_const_iterator(const contiguous_iterator<T, Container> &other) : loc(other.loc),
+                                                                                   iter(other.iter) {}
+
+        contiguous_const_iterator(const Container *vec = nullptr, const T *it = nullptr) : loc(vec), iter(it) {}
+
+        contiguous_const_iterator operator+(const int &n) const {
+            contiguous_const_iterator tmp = *this;
+            tmp.iter += n;
+            return tmp;
+        }
+
+        contiguous_const_iterator operator-(const int &n) const {
+            contiguous_const_iterator tmp = *this;
+            tmp.iter -= n;
+            return tmp;
+        }
+
+        int operator-(const contiguous_const_iterator &rhs) const {
+            if (rhs.loc != this->loc) throw invalid_iterator();
+            return this->iter - rhs.iter;
+        }
+
+        contiguous_const_iterator &operator+=(const int &n) {
+            this->iter += n;
+            return *this;
+        }
+
+        contiguous_const_iterator &operator-=(const int &n) {
+            this->iter -= n;
+            return *this;
+        }
+
+        contiguous_const_iterator operator++(int) {
+            contiguous_const_iterator tmp = *this;
+            (*this) += 1;
+            return tmp;
+        }
+
+        contiguous_const_iterator &operator++() {
+            return (*this) += 1;
+        }
+
+        contiguous_const_iterator operator--(int) {
+            contiguous_const_iterator tmp = *this;
+            (*this) -= 1;
+            return tmp;
+        }
+
+        contiguous_const_iterator &operator--() {
+            return (*this) -= 1;
+        }
+
+        const T &operator*() const {
+            if (loc == nullptr || iter < loc->start || iter >= loc->finish) throw invalid_iterator();
+            return *iter;
+        }
+
+        const T *operator->() const {
+            if (loc == nullptr || iter < loc->start || iter >= loc->finish) throw invalid_iterator();
+            return iter;
+        }
+
+        bool operator==(const contiguous_iterator<T, Container> &rhs) const {
+            return (loc == rhs.loc) && (iter == rhs.iter);
+        }
+
+        bool operator==(const contiguous_const_iterator &rhs) const {
+            return (loc == rhs.loc) && (iter == rhs.iter);
+        }
+
+        bool operator!=(const contiguous_iterator<T, Container> &rhs) const {
+            return !(*this == rhs);
+        }
+
+        bool operator!=(const contiguous_const_iterator &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+
+/**
+ * construction, destruction and relocation of elements in raw storage, shared by the contiguous containers.
+ * trivially copyable elements are relocated and copied with memmove/memcpy,
+ *   everything else goes through move/copy constructors one by one.
+ */
+    template<typename T>
+    class raw_elements {
+    protected:
+        typedef T *pointer;
+        typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value> is_trivial;
+
+        template<class... Args>
+        static void construct(pointer pos, Args &&... args) {
+            new(pos) T(std::forward<Args>(args)...);
+        }
+
+        static void destroy(pointer pos) {
+            pos->~T();
+        }
+
+        /**
+         * destroy [first, last); a no-op for trivially destructible elements.
+         */
+        static void destroy(pointer first, pointer last) {
+            if (std::is_trivially_destructible<T>::value) return;
+            for (; first != last; ++first) destroy(first);
+        }
+
+        /**
+         * move-construct [first, last) into dest and destroy the sources, front to back.
+         * dest may overlap [first, last) as long as dest <= first.
+         */
+        static pointer relocate(pointer first, pointer last, pointer dest) {
+            return relocate(first, last, dest, is_trivial());
+        }
+
+        static pointer relocate(pointer first, pointer last, pointer dest, std::true_type) {
+            size_t n = last - first;
+            if (n) std::memmove(static_cast<void *>(dest), first, n * sizeof(T));
+            return dest + n;
+        }
+
+        static pointer relocate(pointer first, pointer last, pointer dest, std::false_type) {
+            for (; first != last; ++first, ++dest) {
+                construct(dest, std::move(*first));
+                destroy(first);
+            }
+            return dest;
+        }
+
+        /**
+         * relocate [first, last) n slots to the right, back to front.
+         */
+        static void shift_right(pointer first, pointer last, size_t n) {
+            shift_right(first, last, n, is_trivial());
+        }
+
+        static void shift_right(pointer first, pointer last, size_t n, std::true_type) {
+            if (first != last) std::memmove(static_cast<void *>(first + n), first, (last - first) * sizeof(T));
+        }
+
+        static void shift_right(pointer first, pointer last, size_t n, std::false_type) {
+            while (last != first) {
+                --last;
+                construct(last + n, std::move(*last));
+                destroy(last);
+            }
+        }
+
+        /**
+         * copy-construct [first, last) into uninitialized dest.
+         */
+        static pointer copy_construct(const T *first, const T *last, pointer dest) {
+            return copy_construct(first, last, dest, is_trivial());
+        }
+
+        static pointer copy_construct(const T *first, const T *last, pointer dest, std::true_type) {
+            size_t n = last - first;
+            if (n) std::memcpy(static_cast<void *>(dest), first, n * sizeof(T));
+            return dest + n;
+        }
+
+        static pointer copy_construct(const T *first, const T *last, pointer dest, std::false_type) {
+            for (; first != last; ++first, ++dest) construct(dest, *first);
+            return dest;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,137 @@
+#include "small_vector.hpp"
+
+#include "class-integer.hpp"
+#include "class-bint.hpp"
+
+#include <iostream>
+#include <string>
+
+void TestSmallVector()
+{
+	std::cout << "Testing small_vector inline and spilled storage..." << std::endl;
+	sjtu::small_vector<std::string, 4> v;
+	for (int i = 0; i < 4; ++i) {
+		v.push_back(std::to_string(i));
+	}
+	std::cout << v.is_inline() << " " << v.size() << " " << v.capacity() << std::endl;
+	v.emplace_back(v[0]);
+	std::cout << v.is_inline() << " " << v.size() << " " << v.capacity() << std::endl;
+	v.insert(v.begin() + 1, "x");
+	v.erase(v.begin() + 3);
+	v.insert(0, v[2]);
+	for (sjtu::small_vector<std::string, 4>::iterator it = v.begin(); it != v.end(); ++it) {
+		std::cout << *it << " ";
+	}
+	std::cout << std::endl;
+	const sjtu::small_vector<std::string, 4> vc(v);
+	for (sjtu::small_vector<std::string, 4>::const_iterator it = vc.cbegin(); it != vc.cend(); ++it) {
+		std::cout << *it << " ";
+	}
+	std::cout << std::endl;
+	try {
+		std::cout << vc.at(100) << std::endl;
+	} catch(...) {
+		std::cout << "exceptions thrown correctly." << std::endl;
+	}
+	sjtu::small_vector<std::string, 8> s;
+	s.push_back("a");
+	int thrown = 0;
+	try {
+		s.insert(s.end() + 3, "b");
+	} catch (const sjtu::index_out_of_bound &) {
+		++thrown;
+	}
+	try {
+		std::string b("b");
+		s.insert(s.begin() - 1, b);
+	} catch (const sjtu::index_out_of_bound &) {
+		++thrown;
+	}
+	try {
+		s.emplace(s.end() + 1, 2, 'c');
+	} catch (const sjtu::index_out_of_bound &) {
+		++thrown;
+	}
+	s.emplace(s.end(), 2, 'c');
+	std::cout << thrown << " " << s.size() << " " << s.back() << std::endl;
+}
+
+void TestMove()
+{
+	std::cout << "Testing small_vector move..." << std::endl;
+	sjtu::small_vector<Util::Bint, 2> big, small;
+	for (long long i = 1LL << 50; i < (1LL << 50) + 5; ++i) {
+		big.push_back(Util::Bint(i) * i);
+	}
+	small.push_back(Util::Bint(7));
+	sjtu::small_vector<Util::Bint, 2> movedBig(std::move(big)), movedSmall(std::move(small));
+	std::cout << big.size() << " " << small.size() << " " << movedBig.size() << " " << movedSmall.size() << std::endl;
+	movedSmall = std::move(movedBig);
+	for (size_t i = 0; i < movedSmall.size(); ++i) {
+		std::cout << movedSmall[i] << " ";
+	}
+	std::cout << std::endl;
+}
+
+void TestStaticVector()
+{
+	std::cout << "Testing static_vector..." << std::endl;
+	sjtu::static_vector<Integer, 3> v;
+	for (int i = 0; i < 3; ++i) {
+		v.push_back(Integer(i));
+	}
+	try {
+		v.push_back(Integer(3));
+	} catch(sjtu::runtime_error) {
+		std::cout << "full static_vector throws correctly." << std::endl;
+	}
+	v.erase(v.begin(), v.begin() + 2);
+	std::cout << v.size() << " " << v.capacity() << std::endl;
+}
+
+/**
+ * an element whose move throws for one value, as a move that allocates might.
+ */
+class MoveThrows {
+public:
+	std::string text;
+	MoveThrows(const std::string &text) : text(text) {}
+	MoveThrows(const MoveThrows &other) : text(other.text) {}
+	MoveThrows(MoveThrows &&other) : text(other.text) {
+		if (text == "throw") throw sjtu::runtime_error();
+	}
+};
+
+void TestThrowingMove()
+{
+	std::cout << "Testing a throwing element move..." << std::endl;
+	std::cout << std::is_nothrow_move_constructible<sjtu::static_vector<MoveThrows, 4>>::value << " "
+	          << std::is_nothrow_move_constructible<sjtu::static_vector<int, 4>>::value << std::endl;
+	sjtu::static_vector<MoveThrows, 4> v;
+	v.push_back(MoveThrows("a"));
+	MoveThrows bad("throw");
+	v.push_back(bad);
+	try {
+		sjtu::static_vector<MoveThrows, 4> moved(std::move(v));
+	} catch (sjtu::runtime_error) {
+		std::cout << "caught, " << v.size() << " left: " << v[0].text << " " << v[1].text << std::endl;
+	}
+	sjtu::small_vector<MoveThrows, 4> s;
+	s.push_back(bad);
+	sjtu::small_vector<MoveThrows, 4> t;
+	t.push_back(MoveThrows("b"));
+	try {
+		t = std::move(s);
+	} catch (sjtu::runtime_error) {
+		std::cout << "caught, " << s.size() << " " << t.size() << std::endl;
+	}
+}
+
+int main()
+{
+	TestSmallVector();
+	TestMove();
+	TestStaticVector();
+	TestThrowingMove();
+	return 0;
+}
@@ -0,0 +1,114 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <list>
+#include <string>
+
+int Make(int x, int)
+{
+	return x;
+}
+
+std::string Make(int x, const std::string &)
+{
+	return "s" + std::to_string(x);
+}
+
+template<class T>
+void Print(const sjtu::vector<T> &v)
+{
+	std::cout << v.size() << ":";
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << " " << v[i];
+	}
+	std::cout << std::endl;
+}
+
+/**
+ * the range operations on a trivially copyable T (int) and a non-trivial one (std::string).
+ */
+template<class T>
+void TestRanges(const char *name)
+{
+	std::cout << "Testing range operations with " << name << "..." << std::endl;
+	T proto = Make(0, T());
+	sjtu::vector<T> v;
+	T source[50];
+	for (int i = 0; i < 50; ++i) {
+		source[i] = Make(i, proto);
+	}
+	v.assign(source, source + 5);
+	Print(v);
+	v.assign(3, Make(9, proto));
+	Print(v);
+	v.assign(source, source);
+	std::cout << v.size() << " " << v.empty() << std::endl;
+	v.append(source, source + 4);
+	std::list<T> tail;
+	tail.push_back(Make(40, proto));
+	tail.push_back(Make(41, proto));
+	v.append(tail.begin(), tail.end());
+	v.append(v);
+	Print(v);
+	typename sjtu::vector<T>::iterator it = v.insert(v.begin() + 2, source + 10, source + 13);
+	std::cout << *it << " " << (it - v.begin()) << std::endl;
+	it = v.insert(v.begin() + 1, source, source);
+	std::cout << (it - v.begin()) << " " << v.size() << std::endl;
+	it = v.insert(v.end(), 2, Make(7, proto));
+	std::cout << *it << " " << (it - v.begin()) << std::endl;
+	it = v.insert(v.begin(), 0, Make(8, proto));
+	std::cout << (it - v.begin()) << std::endl;
+	Print(v);
+	// longer than the spare capacity, so the insert reallocates
+	it = v.insert(v.begin() + 3, source, source + 50);
+	std::cout << *it << " " << (it - v.begin()) << " " << v.size() << std::endl;
+	it = v.erase(v.begin() + 3, v.begin() + 53);
+	std::cout << *it << " " << (it - v.begin()) << std::endl;
+	it = v.erase(v.begin() + 2, v.begin() + 2);
+	std::cout << *it << " " << (it - v.begin()) << " " << v.size() << std::endl;
+	it = v.erase(v.begin() + 10, v.end());
+	std::cout << (it == v.end()) << std::endl;
+	Print(v);
+	int thrown = 0;
+	try {
+		v.erase(v.begin() + 3, v.begin() + 2);
+	} catch (...) {
+		++thrown;
+	}
+	try {
+		v.erase(v.begin(), v.end() + 1);
+	} catch (...) {
+		++thrown;
+	}
+	sjtu::vector<T> other;
+	try {
+		v.insert(other.begin(), source, source + 2);
+	} catch (...) {
+		++thrown;
+	}
+	try {
+		v.insert(v.end() + 3, source, source + 2);
+	} catch (const sjtu::index_out_of_bound &) {
+		++thrown;
+	}
+	try {
+		v.insert(v.begin() - 1, 2, source[0]);
+	} catch (const sjtu::index_out_of_bound &) {
+		++thrown;
+	}
+	try {
+		v.insert(v.end() + 3, 2, source[0]);
+	} catch (const sjtu::index_out_of_bound &) {
+		++thrown;
+	}
+	std::cout << thrown << " " << v.size() << std::endl;
+	it = v.erase(v.begin(), v.end());
+	std::cout << v.size() << " " << (it == v.end()) << std::endl;
+}
+
+int main()
+{
+	TestRanges<int>("int");
+	TestRanges<std::string>("std::string");
+	return 0;
+}
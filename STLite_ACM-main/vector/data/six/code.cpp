@@ -0,0 +1,138 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <string>
+
+/**
+ * a non-trivial element that counts its live objects and remembers whether it was moved from.
+ */
+class Tracked {
+public:
+	static int alive;
+	std::string text;
+	Tracked(const std::string &text = "") : text(text) {
+		++alive;
+	}
+	Tracked(int a, int b) : text(std::to_string(a) + "+" + std::to_string(b)) {
+		++alive;
+	}
+	Tracked(const Tracked &other) : text(other.text) {
+		++alive;
+	}
+	Tracked(Tracked &&other) : text(std::move(other.text)) {
+		other.text = "<moved>";
+		++alive;
+	}
+	Tracked &operator=(const Tracked &other) {
+		text = other.text;
+		return *this;
+	}
+	Tracked &operator=(Tracked &&other) {
+		text = std::move(other.text);
+		other.text = "<moved>";
+		return *this;
+	}
+	~Tracked() {
+		--alive;
+	}
+};
+
+int Tracked::alive = 0;
+
+template<class T>
+void Print(const sjtu::vector<T> &v)
+{
+	std::cout << v.size() << ":";
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << " " << v[i];
+	}
+	std::cout << std::endl;
+}
+
+void Print(const sjtu::vector<Tracked> &v)
+{
+	std::cout << v.size() << ":";
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << " " << v[i].text;
+	}
+	std::cout << std::endl;
+}
+
+void TestTrivialMove()
+{
+	std::cout << "Testing move and emplace with int..." << std::endl;
+	sjtu::vector<int> a;
+	for (int i = 0; i < 40; ++i) {
+		a.emplace_back(i * i);
+	}
+	const int *data = a.data();
+	sjtu::vector<int> b(std::move(a));
+	std::cout << a.size() << " " << b.size() << " " << (b.data() == data) << std::endl;
+	a.push_back(7);
+	b = std::move(a);
+	Print(b);
+	std::cout << a.size() << std::endl;
+	b.emplace(b.begin(), 1);
+	b.emplace(b.end(), 9);
+	b.emplace(b.begin() + 1, 5);
+	int x = 3;
+	b.insert(b.begin(), std::move(x));
+	b.push_back(std::move(x));
+	Print(b);
+	b = std::move(b);
+	Print(b);
+}
+
+void TestNonTrivialMove()
+{
+	std::cout << "Testing move and emplace with a non-trivial type..." << std::endl;
+	{
+		sjtu::vector<Tracked> a;
+		for (int i = 0; i < 20; ++i) {
+			a.emplace_back(i, i + 1);
+		}
+		sjtu::vector<Tracked> b(std::move(a));
+		std::cout << a.size() << " " << b.size() << " " << Tracked::alive << std::endl;
+		Tracked t("pushed");
+		b.push_back(std::move(t));
+		std::cout << t.text << " " << b.back().text << std::endl;
+		Tracked &added = b.emplace_back(100, 200);
+		std::cout << added.text << std::endl;
+		b.emplace(b.begin() + 2, 7, 8);
+		Tracked u("inserted");
+		b.insert(b.begin(), std::move(u));
+		std::cout << u.text << std::endl;
+		sjtu::vector<Tracked> c;
+		c.emplace_back("old");
+		c = std::move(b);
+		std::cout << b.size() << " " << c.size() << std::endl;
+		for (size_t i = 0; i < 5; ++i) {
+			std::cout << c[i].text << " ";
+		}
+		std::cout << c.back().text << std::endl;
+		sjtu::vector<Tracked> d(c);
+		d = std::move(d);
+		std::cout << d.size() << " " << d[3].text << " " << c[3].text << std::endl;
+		std::cout << Tracked::alive << std::endl;
+		int thrown = 0;
+		try {
+			d.emplace(d.end() + 3, "past the end");
+		} catch (const sjtu::index_out_of_bound &) {
+			++thrown;
+		}
+		try {
+			d.emplace(d.begin() - 1, 1, 2);
+		} catch (const sjtu::index_out_of_bound &) {
+			++thrown;
+		}
+		std::cout << thrown << " " << d.size() << " " << Tracked::alive << std::endl;
+	}
+	std::cout << "alive: " << Tracked::alive << std::endl;
+}
+
+int main()
+{
+	TestTrivialMove();
+	TestNonTrivialMove();
+	return 0;
+}
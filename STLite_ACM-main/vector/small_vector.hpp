@@ -0,0 +1,390 @@
+#ifndef SJTU_SMALL_VECTOR_HPP
+#define SJTU_SMALL_VECTOR_HPP
+
+#include "exceptions.hpp"
+#include "contiguous.hpp"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+/**
+ * a vector which keeps its first N elements in an inline buffer inside the object.
+ * with Spill it moves to the heap once more than N elements are stored (small_vector),
+ *   without Spill it never allocates and throws runtime_error when full (static_vector).
+ * the iterator, at() and operator[] behave like those of sjtu::vector.
+ */
+    template<typename T, size_t N, bool Spill>
+    class inline_vector : private raw_elements<T> {
+        static_assert(N > 0, "inline_vector needs a non-empty inline buffer");
+
+        typedef T value_type;
+        typedef value_type *pointer;
+        typedef value_type &reference;
+
+        typedef raw_elements<T> elements;
+        typedef typename elements::is_trivial is_trivial;
+        using elements::construct;
+        using elements::destroy;
+        using elements::relocate;
+        using elements::shift_right;
+
+    private:
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer[N];
+        pointer start;
+        pointer finish;
+        pointer end_of_storage;
+
+    public:
+        typedef contiguous_iterator<T, inline_vector> iterator;
+        typedef contiguous_const_iterator<T, inline_vector> const_iterator;
+
+        friend iterator;
+        friend const_iterator;
+
+    private:
+        pointer inline_start() {
+            return reinterpret_cast<pointer>(buffer);
+        }
+
+        void release() {
+            if (!is_inline()) ::operator delete(start);
+        }
+
+        /**
+         * move the elements into heap storage of the given capacity.
+         */
+        void create(size_t size) {
+            if (!Spill) throw runtime_error();
+            pointer tmp = static_cast<pointer>(::operator new(size * sizeof(value_type)));
+            pointer cur = relocate(start, finish, tmp);
+            release();
+            start = tmp;
+            finish = cur;
+            end_of_storage = tmp + size;
+        }
+
+        void reset() {
+            start = finish = inline_start();
+            end_of_storage = start + N;
+        }
+
+        void copy_from(const inline_vector &other) {
+            if (other.size() > capacity()) create(other.size());
+            for (const T *iter = other.start; iter != other.finish; ++iter, ++finish) construct(finish, *iter);
+        }
+
+        void move_from(inline_vector &other) {
+            if (!other.is_inline()) {
+                start = other.start;
+                finish = other.finish;
+                end_of_storage = other.end_of_storage;
+                other.reset();
+            } else if (is_trivial::value) {
+                finish = relocate(other.start, other.finish, start);
+                other.finish = other.start;
+            } else {
+                // the sources are destroyed only once every move has succeeded, so a throwing move
+                //   leaves other whole (if partly moved-from) and this empty
+                pointer cur = start;
+                try {
+                    for (pointer iter = other.start; iter != other.finish; ++iter, ++cur) {
+                        construct(cur, std::move(*iter));
+                    }
+                } catch (...) {
+                    destroy(start, cur);
+                    throw;
+                }
+                destroy(other.start, other.finish);
+                finish = cur;
+                other.finish = other.start;
+            }
+        }
+
+    public:
+        inline_vector() {
+            reset();
+        }
+
+        inline_vector(const inline_vector &other) {
+            reset();
+            copy_from(other);
+        }
+
+        /**
+         * takes over the heap storage of other, or moves its inline elements one by one;
+         *   the latter runs for both small_vector and static_vector, so noexcept follows the element move.
+         */
+        inline_vector(inline_vector &&other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+            reset();
+            move_from(other);
+        }
+
+        ~inline_vector() {
+            destroy(start, finish);
+            release();
+        }
+
+        inline_vector &operator=(const inline_vector &other) {
+            if (this == &other) return *this;
+            clear();
+            copy_from(other);
+            return *this;
+        }
+
+        inline_vector &operator=(inline_vector &&other) {
+            if (this == &other) return *this;
+            destroy(start, finish);
+            release();
+            reset();
+            move_from(other);
+            return *this;
+        }
+
+        /**
+         * assigns specified element with bounds checking
+         * throw index_out_of_bound if pos is not in [0, size)
+         */
+        T &at(const size_t &pos) {
+            if (pos >= size()) throw index_out_of_bound();
+            return start[pos];
+        }
+
+        const T &at(const size_t &pos) const {
+            if (pos >= size()) throw index_out_of_bound();
+            return start[pos];
+        }
+
+        T &operator[](const size_t &pos) {
+            if (pos >= size()) throw index_out_of_bound();
+            return start[pos];
+        }
+
+        const T &operator[](const size_t &pos) const {
+            if (pos >= size()) throw index_out_of_bound();
+            return start[pos];
+        }
+
+        /**
+         * access the first element.
+         * throw container_is_empty if size == 0
+         */
+        const T &front() const {
+            if (empty()) throw container_is_empty();
+            return *start;
+        }
+
+        /**
+         * access the last element.
+         * throw container_is_empty if size == 0
+         */
+        const T &back() const {
+            if (empty()) throw container_is_empty();
+            return *(finish - 1);
+        }
+
+        T *data() {
+            return start;
+        }
+
+        const T *data() const {
+            return start;
+        }
+
+        iterator begin() {
+            return iterator(this, start);
+        }
+
+        const_iterator cbegin() const {
+            return const_iterator(this, start);
+        }
+
+        iterator end() {
+            return iterator(this, finish);
+        }
+
+        const_iterator cend() const {
+            return const_iterator(this, finish);
+        }
+
+        bool empty() const {
+            return start == finish;
+        }
+
+        size_t size() const {
+            return finish - start;
+        }
+
+        size_t capacity() const {
+            return end_of_storage - start;
+        }
+
+        /**
+         * whether the elements still live in the inline buffer.
+         */
+        bool is_inline() const {
+            return start == reinterpret_cast<const T *>(buffer);
+        }
+
+        /**
+         * makes sure the capacity is at least n.
+         * throw runtime_error if n > N and the vector may not spill to the heap.
+         */
+        void reserve(size_t n) {
+            if (n > capacity()) create(n);
+        }
+
+        void clear() {
+            destroy(start, finish);
+            finish = start;
+        }
+
+        /**
+         * inserts value before pos
+         * returns an iterator pointing to the inserted value.
+         */
+        iterator insert(iterator pos, const T &value) {
+            if (pos.loc != this) throw invalid_iterator();
+            return insert(size_t(pos.iter - start), value);
+        }
+
+        iterator insert(iterator pos, T &&value) {
+            if (pos.loc != this) throw invalid_iterator();
+            return insert(size_t(pos.iter - start), std::move(value));
+        }
+
+        /**
+         * inserts value at index ind.
+         * throw index_out_of_bound if ind > size
+         */
+        iterator insert(const size_t &ind, const T &value) {
+            if (ind > size()) throw index_out_of_bound();
+            return emplace_at(ind, value);
+        }
+
+        iterator insert(const size_t &ind, T &&value) {
+            if (ind > size()) throw index_out_of_bound();
+            return emplace_at(ind, std::move(value));
+        }
+
+        /**
+         * constructs an element in place before pos from args.
+         * throw index_out_of_bound if pos is not in [begin(), end()]
+         */
+        template<class... Args>
+        iterator emplace(iterator pos, Args &&... args) {
+            if (pos.loc != this) throw invalid_iterator();
+            if (pos.iter < start || pos.iter > finish) throw index_out_of_bound();
+            return emplace_at(pos.iter - start, std::forward<Args>(args)...);
+        }
+
+        /**
+         * removes the element at pos.
+         * return an iterator pointing to the following element.
+         */
+        iterator erase(iterator pos) {
+            if (pos.loc != this) throw invalid_iterator();
+            return erase(size_t(pos.iter - start));
+        }
+
+        /**
+         * removes the element with index ind.
+         * throw index_out_of_bound if ind >= size
+         */
+        iterator erase(const size_t &ind) {
+            if (ind >= size()) throw index_out_of_bound();
+            destroy(start + ind);
+            relocate(start + ind + 1, finish, start + ind);
+            --finish;
+            return iterator(this, start + ind);
+        }
+
+        /**
+         * removes the elements in [first, last).
+         */
+        iterator erase(iterator first, iterator last) {
+            if (first.loc != this || last.loc != this) throw invalid_iterator();
+            if (first.iter < start || last.iter > finish || first.iter > last.iter) throw invalid_iterator();
+            pointer pos = start + (first.iter - start);
+            destroy(pos, pos + (last.iter - first.iter));
+            finish = relocate(pos + (last.iter - first.iter), finish, pos);
+            return iterator(this, pos);
+        }
+
+        void push_back(const T &value) {
+            emplace_at(size(), value);
+        }
+
+        void push_back(T &&value) {
+            emplace_at(size(), std::move(value));
+        }
+
+        template<class... Args>
+        T &emplace_back(Args &&... args) {
+            return *emplace_at(size(), std::forward<Args>(args)...);
+        }
+
+        /**
+         * remove the last element from the end.
+         * throw container_is_empty if size() == 0
+         */
+        void pop_back() {
+            if (empty()) throw container_is_empty();
+            --finish;
+            destroy(finish);
+        }
+
+    private:
+        /**
+         * construct an element from args at index ind, see vector::emplace_at.
+         */
+        template<class... Args>
+        iterator emplace_at(const size_t &ind, Args &&... args) {
+            if (finish == end_of_storage) {
+                if (!Spill) throw runtime_error();
+                size_t cap = capacity() << 1;
+                pointer tmp = static_cast<pointer>(::operator new(cap * sizeof(value_type)));
+                try {
+                    construct(tmp + ind, std::forward<Args>(args)...);
+                } catch (...) {
+                    ::operator delete(tmp);
+                    throw;
+                }
+                relocate(start, start + ind, tmp);
+                pointer cur = relocate(start + ind, finish, tmp + ind + 1);
+                release();
+                start = tmp;
+                finish = cur;
+                end_of_storage = tmp + cap;
+                return iterator(this, start + ind);
+            }
+            pointer pos = start + ind;
+            if (pos == finish) {
+                construct(finish, std::forward<Args>(args)...);
+            } else {
+                value_type tmp(std::forward<Args>(args)...);
+                shift_right(pos, finish, 1);
+                construct(pos, std::move(tmp));
+            }
+            ++finish;
+            return iterator(this, pos);
+        }
+    };
+
+/**
+ * keeps up to N elements inline and spills to the heap past that.
+ */
+    template<typename T, size_t N = 8>
+    using small_vector = inline_vector<T, N, true>;
+
+/**
+ * at most N elements, always inline, never allocates.
+ * growing past N throws runtime_error.
+ */
+    template<typename T, size_t N>
+    using static_vector = inline_vector<T, N, false>;
+
+}
+
+#endif
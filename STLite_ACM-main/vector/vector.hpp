@@ -3,253 +3,121 @@
 
 #include "exceptions.hpp"
 #include "utility.hpp"
+#include "allocator.hpp"
+#include "contiguous.hpp"
 #include <climits>
 #include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace sjtu {
 /**
  * a data container like std::vector
  * store data in a successive memory and support random access.
  */
-    template<typename T>
-    class vector {
+    template<typename T, class Alloc = allocator<T>>
+    class vector : private raw_elements<T> {
         typedef T value_type;
-        typedef value_type **pointer;
-        typedef value_type *pointer_;
+        typedef value_type *pointer;
         typedef value_type &reference;
 
+        typedef raw_elements<T> elements;
+        using elements::construct;
+        using elements::destroy;
+        using elements::relocate;
+        using elements::shift_right;
+        using elements::copy_construct;
+        typedef std::allocator_traits<Alloc> alloc_traits;
+
     private:
+        /**
+         * elements live contiguously in raw storage:
+         *   [start, finish) holds constructed elements,
+         *   [finish, end_of_storage) is uninitialized.
+         */
         pointer start;
         pointer finish;
         pointer end_of_storage;
+        Alloc alloc;
 
     public:
         /**
-         * TODO
-         * a type for actions of the elements of a vector, and you should write
-         *   a class named const_iterator with same interfaces.
+         * the iterators are pointers into [start, finish) checked against this vector, see contiguous.hpp.
          */
-        /**
-         * you can see RandomAccessIterator at CppReference for help.
-         */
-        class const_iterator;
-
-        class iterator {
-            friend vector<T>;
-        private:
-            const vector<T> *loc;
-
-            T **iter;
-        public:
-            iterator(const iterator &other) : loc(other.loc), iter(other.iter) {}
-
-            iterator(vector<T> *vec = nullptr, T **it = nullptr) : loc(vec), iter(it) {}
-
-            /**
-             * return a new iterator which pointer n-next elements
-             * as well as operator-
-             */
-            iterator operator+(const int &n) const {
-//                int offset = iter - loc->start + n;
-//                if (offset > loc->finish - loc->start) throw invalid_iterator();
-                iterator tmp = *this;
-                tmp.iter += n;
-                return tmp;
-            }
-
-            iterator operator-(const int &n) const {
-//                int offset = iter - loc->start - n;
-//                if (offset < 0) throw invalid_iterator();
-                iterator tmp = *this;
-                tmp.iter -= n;
-                return tmp;
-            }
+        typedef contiguous_iterator<T, vector> iterator;
+        typedef contiguous_const_iterator<T, vector> const_iterator;
 
-            // return the distance between two iterators,
-            // if these two iterators point to different vectors, throw invaild_iterator.
-            int operator-(const iterator &rhs) const {
-                if (rhs.loc != this->loc) throw invalid_iterator();
-                return this->iter - rhs.iter;
-            }
-
-            iterator &operator+=(const int &n) {
-                this->iter += n;
-                return *this;
-            }
-
-            iterator &operator-=(const int &n) {
-                this->iter -= n;
-                return *this;
-            }
-
-            iterator operator++(int) {
-                iterator tmp = *this;
-                (*this) += 1;
-                return tmp;
-            }
-
-            iterator &operator++() {
-                return (*this) += 1;
-            }
+        friend iterator;
+        friend const_iterator;
 
-            iterator operator--(int) {
-                iterator tmp = *this;
-                (*this) -= 1;
-                return tmp;
-            }
-
-            iterator &operator--() {
-                return (*this) -= 1;
-            }
-
-            T &operator*() const {
-                if (loc == nullptr || iter < loc->start || iter > loc->finish) throw invalid_iterator();
-                return **iter;
-            }
-
-            bool operator==(const iterator &rhs) const {
-                return (loc == rhs.loc) && (iter == rhs.iter);
-            }
-
-            bool operator==(const const_iterator &rhs) const {
-                return (loc == rhs.loc) && (iter == rhs.iter);
-            }
-
-            bool operator!=(const iterator &rhs) const {
-                return !(*this == rhs);
-            }
+    private:
+        pointer allocate(size_t n) {
+            return alloc_traits::allocate(alloc, n);
+        }
 
-            bool operator!=(const const_iterator &rhs) const {
-                return !(*this == rhs);
-            }
-        };
+        void deallocate(pointer p, size_t n) {
+            alloc_traits::deallocate(alloc, p, n);
+        }
 
         /**
-         * has same function as iterator, just for a const object.
+         * give back the current storage, whose elements must already be destroyed or relocated.
          */
-        class const_iterator {
-            friend vector<T>;
-        private:
-            const vector<T> *loc;
-
-            T **iter;
-        public:
-            const_iterator(const const_iterator &other) : loc(other.loc), iter(other.iter) {}
-
-            const_iterator(vector<T> *vec = nullptr, T **it = nullptr) : loc(vec), iter(it) {}
-
-            /**
-             * return a new iterator which pointer n-next elements
-             * as well as operator-
-             */
-            const_iterator operator+(const int &n) const {
-//                int offset = iter - loc->start + n;
-//                if (offset > loc->finish - loc->start) throw invalid_iterator();
-                iterator tmp = *this;
-                tmp.iter += n;
-                return tmp;
-            }
-
-            const_iterator operator-(const int &n) const {
-//                int offset = iter - loc->start - n;
-//                if (offset < 0) throw invalid_iterator();
-                iterator tmp = *this;
-                tmp.iter -= n;
-                return tmp;
-            }
-
-            int operator-(const iterator &rhs) const {
-                if (rhs.loc != this->loc) throw invalid_iterator();
-                return this->iter - rhs.iter;
-            }
-
-            const_iterator &operator+=(const int &n) {
-                this->iter += n;
-                return *this;
-            }
-
-            const_iterator &operator-=(const int &n) {
-                this->iter -= n;
-                return *this;
-            }
-
-            const_iterator operator++(int) {
-                iterator tmp = *this;
-                (*this) += 1;
-                return tmp;
-            }
-
-            const_iterator &operator++() {
-                return (*this) += 1;
-            }
-
-            const_iterator operator--(int) {
-                iterator tmp = *this;
-                (*this) -= 1;
-                return tmp;
-            }
-
-            const_iterator &operator--() {
-                return (*this) -= 1;
-            }
-
-            const T &operator*() const {
-                if (loc == nullptr || iter < loc->start || iter > loc->finish) throw invalid_iterator();
-                return **iter;
-            }
-
-            bool operator==(const iterator &rhs) const {
-                return (loc == rhs.loc) && (iter == rhs.iter);
-            }
+        void release() {
+            if (start) deallocate(start, capacity());
+        }
 
-            bool operator==(const const_iterator &rhs) const {
-                return (loc == rhs.loc) && (iter == rhs.iter);
-            }
+        /**
+         * move the elements into a new storage of the given capacity.
+         */
+        void create(size_t size = 1 << 4) {
+            pointer tmp = allocate(size);
+            pointer cur = relocate(start, finish, tmp);
+            release();
+            start = tmp;
+            finish = cur;
+            end_of_storage = tmp + size;
+        }
 
-            bool operator!=(const iterator &rhs) const {
-                return !(*this == rhs);
-            }
+        size_t next_capacity() const {
+            return start == nullptr ? 1 << 4 : capacity() << 1;
+        }
 
-            bool operator!=(const const_iterator &rhs) const {
-                return !(*this == rhs);
-            }
-        };
+        /**
+         * smallest power-of-two growth of the current capacity that holds n elements.
+         */
+        size_t grown_capacity(size_t n) const {
+            size_t cap = next_capacity();
+            while (cap < n) cap <<= 1;
+            return cap;
+        }
 
-    private:
-        iterator create(int size = 1 << 4) {
-            pointer tmp = new pointer_[size];
-            if (start == nullptr) {
-                start = tmp;
-                finish = tmp - 1;
-                end_of_storage = tmp + size - 1;
-            } else {
-                for (auto iter = start; iter != end_of_storage + 1; ++iter) {
-                    tmp[iter - start] = *iter;
-                    *iter = nullptr;
-                }
-                int old_size = capacity() + 1;
-                destroy();
-                finish = tmp + old_size - 1;
-                start = tmp;
-                end_of_storage = tmp + size - 1;
-            }
-            return iterator(this, start);
+        template<class InputIt>
+        static size_t distance(InputIt first, InputIt last) {
+            size_t n = 0;
+            for (; first != last; ++first) ++n;
+            return n;
         }
 
-        void construct(pointer pos, const T &x) {
-            ++pos;
-            *pos = new value_type(x);
+        void steal(vector &other) {
+            start = other.start;
+            finish = other.finish;
+            end_of_storage = other.end_of_storage;
+            other.start = other.finish = other.end_of_storage = nullptr;
         }
 
         void destroy() {
             if (start == nullptr) return;
-            auto iter = start;
-            while (finish - iter >= 0) {
-                if (*iter != nullptr) delete *iter;
-                ++iter;
-            }
-            delete[] start;
-            start = nullptr;
+            destroy(start, finish);
+            release();
+            start = finish = end_of_storage = nullptr;
+        }
+
+        void copy_from(const vector &other) {
+            if (other.start == nullptr) return;
+            create(other.capacity());
+            finish = copy_construct(other.start, other.finish, start);
         }
 
     public:
@@ -257,13 +125,25 @@ namespace sjtu {
          * TODO Constructs
          * Atleast two: default constructor, copy constructor
          */
-        vector() : start(nullptr), finish(nullptr), end_of_storage(nullptr) {}
+        vector() : start(nullptr), finish(nullptr), end_of_storage(nullptr), alloc() {}
 
-        vector(const vector &other) {
-            start = nullptr;
-            create(other.capacity() + 1);
-            finish = other.size() + start - 1;
-            for (int i = 0; i < other.size(); ++i) start[i] = new value_type(*(other.start[i]));
+        /**
+         * an empty vector drawing its storage from alloc.
+         */
+        explicit vector(const Alloc &alloc) : start(nullptr), finish(nullptr), end_of_storage(nullptr),
+                                              alloc(alloc) {}
+
+        vector(const vector &other) : start(nullptr), finish(nullptr), end_of_storage(nullptr),
+                                      alloc(other.alloc) {
+            copy_from(other);
+        }
+
+        /**
+         * takes over the storage of other, leaving it empty. O(1).
+         */
+        vector(vector &&other) noexcept : start(nullptr), finish(nullptr), end_of_storage(nullptr),
+                                          alloc(std::move(other.alloc)) {
+            steal(other);
         }
 
         /**
@@ -279,9 +159,18 @@ namespace sjtu {
         vector &operator=(const vector &other) {
             if (this == &other) return *this;
             destroy();
-            create(other.capacity() + 1);
-            finish = other.size() + start - 1;
-            for (int i = 0; i < other.size(); ++i) start[i] = new value_type(*(other.start[i]));
+            copy_from(other);
+            return *this;
+        }
+
+        /**
+         * the allocator travels with the storage.
+         */
+        vector &operator=(vector &&other) noexcept {
+            if (this == &other) return *this;
+            destroy();
+            alloc = other.alloc;
+            steal(other);
             return *this;
         }
 
@@ -290,13 +179,13 @@ namespace sjtu {
          * throw index_out_of_bound if pos is not in [0, size)
          */
         T &at(const size_t &pos) {
-            if (pos < 0 || pos >= size()) throw index_out_of_bound();
-            return **(start + pos);
+            if (pos >= size()) throw index_out_of_bound();
+            return start[pos];
         }
 
         const T &at(const size_t &pos) const {
-            if (pos < 0 || pos >= size()) throw index_out_of_bound();
-            return **(start + pos);
+            if (pos >= size()) throw index_out_of_bound();
+            return start[pos];
         }
 
         /**
@@ -306,13 +195,13 @@ namespace sjtu {
          *   In STL this operator does not check the boundary but I want you to do.
          */
         T &operator[](const size_t &pos) {
-            if (pos < 0 || pos >= size()) throw index_out_of_bound();
-            return **(start + pos);
+            if (pos >= size()) throw index_out_of_bound();
+            return start[pos];
         }
 
         const T &operator[](const size_t &pos) const {
-            if (pos < 0 || pos >= size()) throw index_out_of_bound();
-            return **(start + pos);
+            if (pos >= size()) throw index_out_of_bound();
+            return start[pos];
         }
 
         /**
@@ -320,8 +209,8 @@ namespace sjtu {
          * throw container_is_empty if size == 0
          */
         const T &front() const {
-            if (finish - start == 0) throw container_is_empty();
-            return **start;
+            if (empty()) throw container_is_empty();
+            return *start;
         }
 
         /**
@@ -329,8 +218,24 @@ namespace sjtu {
          * throw container_is_empty if size == 0
          */
         const T &back() const {
-            if (finish - start == 0) throw container_is_empty();
-            return **finish;
+            if (empty()) throw container_is_empty();
+            return *(finish - 1);
+        }
+
+        Alloc get_allocator() const {
+            return alloc;
+        }
+
+        /**
+         * direct access to the underlying contiguous storage.
+         * [data(), data() + size()) is a valid range, data() may be nullptr if nothing was ever stored.
+         */
+        T *data() {
+            return start;
+        }
+
+        const T *data() const {
+            return start;
         }
 
         /**
@@ -341,53 +246,89 @@ namespace sjtu {
         }
 
         const_iterator cbegin() const {
-            const_iterator const_iter;
-            const_iter.loc = this;
-            const_iter.iter = start;
-            return const_iter;
+            return const_iterator(this, start);
         }
 
         /**
          * returns an iterator to the end.
          */
         iterator end() {
-            return iterator(this, finish + 1);
+            return iterator(this, finish);
         }
 
         const_iterator cend() const {
-            const_iterator const_iter;
-            const_iter.loc = this;
-            const_iter.iter = finish + 1;
-            return const_iter;
+            return const_iterator(this, finish);
         }
 
         /**
          * checks whether the container is empty
          */
         bool empty() const {
-            if (start == nullptr) return true;
-            return start == finish + 1;
+            return start == finish;
         }
 
         /**
          * returns the number of elements
          */
         size_t size() const {
-            if (empty()) return 0;
-            int size = finish - start + 1;
-            return finish - start + 1;
+            return finish - start;
         }
 
         size_t capacity() const {
             return end_of_storage - start;
         }
 
+        /**
+         * makes sure the capacity is at least n, reallocating at most once.
+         */
+        void reserve(size_t n) {
+            if (n > capacity()) create(n);
+        }
+
         /**
          * clears the contents
          */
         void clear() {
-            for (auto iter = start; iter != finish + 1; ++iter) delete *iter;
-            finish = start - 1;
+            destroy(start, finish);
+            finish = start;
+        }
+
+        /**
+         * replaces the contents with n copies of value.
+         */
+        void assign(size_t n, const T &value) {
+            value_type tmp(value);
+            clear();
+            reserve(n);
+            for (; n > 0; --n, ++finish) construct(finish, tmp);
+        }
+
+        /**
+         * replaces the contents with the elements of [first, last).
+         * [first, last) must be a multi-pass range that does not point into this vector.
+         */
+        template<class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        void assign(InputIt first, InputIt last) {
+            clear();
+            reserve(distance(first, last));
+            for (; first != last; ++first, ++finish) construct(finish, *first);
+        }
+
+        /**
+         * adds the elements of [first, last) to the end.
+         */
+        template<class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        void append(InputIt first, InputIt last) {
+            insert_range(size(), first, last);
+        }
+
+        void append(const vector &other) {
+            if (this == &other) {
+                vector tmp(other);
+                insert_range(size(), tmp.start, tmp.finish);
+            } else {
+                insert_range(size(), other.start, other.finish);
+            }
         }
 
         /**
@@ -395,30 +336,60 @@ namespace sjtu {
          * returns an iterator pointing to the inserted value.
          */
         iterator insert(iterator pos, const T &value) {
-            if (start == nullptr) create();
-            int dis = pos - begin();
-            if (finish == end_of_storage) {
-                size_t old = size();
-                create(2 * old);
-//                const int old_size = size();
-//                const int new_size = old_size != 0 ? 2 * old_size : 1;
-//
-//                vector<value_type> new_vector;
-//                new_vector.create(new_size);
-//                new_vector.finish = new_vector.start + size() - 1;
-//                for (int i = 0; i < size(); ++i) new_vector.start[i] = new value_type(*(start[i]));
-//                *this = new_vector;
-            }
-            /*start[size()] = new value_type(**finish);
-//            construct(finish, **finish);
-            ++finish;
-            for (auto iter = iterator(this, finish - 1); iter != pos; --iter) *(iter + 1) = *iter;
-            *pos = value;*/
-//            for (auto iter = iterator(this, finish++); iter != pos; --iter) *(iter + 1) = *iter;
-            for (int i = size() - 1; i >= dis; --i) start[i + 1] = start[i];
-            ++finish;
-            start[dis] = new value_type(value);
-            return iterator(this, start + (pos - begin()));
+            if (pos.loc != this) throw invalid_iterator();
+            return insert(size_t(pos.iter - start), value);
+        }
+
+        iterator insert(iterator pos, T &&value) {
+            if (pos.loc != this) throw invalid_iterator();
+            return insert(size_t(pos.iter - start), std::move(value));
+        }
+
+        /**
+         * inserts n copies of value before pos.
+         * returns an iterator pointing to the first inserted element (or pos if n == 0).
+         * throw index_out_of_bound if pos is not in [begin(), end()]
+         */
+        iterator insert(iterator pos, size_t n, const T &value) {
+            if (pos.loc != this) throw invalid_iterator();
+            if (pos.iter < start || pos.iter > finish) throw index_out_of_bound();
+            size_t ind = pos.iter - start;
+            if (n == 0) return iterator(this, start + ind);
+            value_type tmp(value);
+            pointer gap = open_gap(ind, n);
+            size_t built = 0;
+            try {
+                for (; built < n; ++built) construct(gap + built, tmp);
+            } catch (...) {
+                close_gap(ind, n, built);
+                throw;
+            }
+            return iterator(this, gap);
+        }
+
+        /**
+         * inserts the elements of [first, last) before pos.
+         * [first, last) must be a multi-pass range that does not point into this vector.
+         * returns an iterator pointing to the first inserted element (or pos if the range is empty).
+         * throw index_out_of_bound if pos is not in [begin(), end()]
+         */
+        template<class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        iterator insert(iterator pos, InputIt first, InputIt last) {
+            if (pos.loc != this) throw invalid_iterator();
+            if (pos.iter < start || pos.iter > finish) throw index_out_of_bound();
+            return insert_range(pos.iter - start, first, last);
+        }
+
+        /**
+         * constructs an element in place before pos from args.
+         * returns an iterator pointing to the new element.
+         * throw index_out_of_bound if pos is not in [begin(), end()]
+         */
+        template<class... Args>
+        iterator emplace(iterator pos, Args &&... args) {
+            if (pos.loc != this) throw invalid_iterator();
+            if (pos.iter < start || pos.iter > finish) throw index_out_of_bound();
+            return emplace_at(pos.iter - start, std::forward<Args>(args)...);
         }
 
         /**
@@ -428,25 +399,13 @@ namespace sjtu {
          * throw index_out_of_bound if ind > size (in this situation ind can be size because after inserting the size will increase 1.)
          */
         iterator insert(const size_t &ind, const T &value) {
-            if (start == nullptr) create();
             if (ind > size()) throw index_out_of_bound();
-            if (finish == end_of_storage) {
-                create(2 * size());
-//                vector<value_type> new_vector;
-//                new_vector.create(2 * size());
-//                new_vector.finish = new_vector.start + size() - 1;
-//                for (int i = 0; i < size(); ++i) new_vector.start[i] = new value_type(*(start[i]));
-//                *this = new_vector;
-            }
-            /*start[size()] = new value_type(back());
-//            construct(finish, **finish);
-            ++finish;
-            for (int i = size() - 1; i > ind; --i) at(i) = at(i - 1);
-            at(ind) = value;*/
-            for (int i = size(); i > ind; --i) start[i] = start[i - 1];
-            ++finish;
-            start[ind] = new value_type(value);
-            return iterator(this, start + ind);
+            return emplace_at(ind, value);
+        }
+
+        iterator insert(const size_t &ind, T &&value) {
+            if (ind > size()) throw index_out_of_bound();
+            return emplace_at(ind, std::move(value));
         }
 
         /**
@@ -455,12 +414,8 @@ namespace sjtu {
          * If the iterator pos refers the last element, the end() iterator is returned.
          */
         iterator erase(iterator pos) {
-            pointer iter = start + (pos - begin());
-            delete *iter;
-            for (; iter != finish; ++iter) *iter = *(iter + 1);
-            --finish;
-            if (pos - begin() >= size()) return end();
-            return iterator(this, start + (pos - begin()));
+            if (pos.loc != this) throw invalid_iterator();
+            return erase(size_t(pos.iter - start));
         }
 
         /**
@@ -470,18 +425,44 @@ namespace sjtu {
          */
         iterator erase(const size_t &ind) {
             if (ind >= size()) throw index_out_of_bound();
-            delete *(start + ind);
-            for (int i = ind; i < size(); ++i) at(i) = at(i + 1);
+            destroy(start + ind);
+            relocate(start + ind + 1, finish, start + ind);
             --finish;
-            if (ind == size() - 1) return end();
-            return start + ind;
+            return iterator(this, start + ind);
+        }
+
+        /**
+         * removes the elements in [first, last), shifting the tail only once.
+         * returns an iterator pointing to the element that followed the erased range.
+         */
+        iterator erase(iterator first, iterator last) {
+            if (first.loc != this || last.loc != this) throw invalid_iterator();
+            if (first.iter < start || last.iter > finish || first.iter > last.iter) throw invalid_iterator();
+            pointer pos = start + (first.iter - start);
+            if (first.iter == last.iter) return iterator(this, pos);
+            destroy(pos, pos + (last.iter - first.iter));
+            finish = relocate(pos + (last.iter - first.iter), finish, pos);
+            return iterator(this, pos);
         }
 
         /**
          * adds an element to the end.
          */
         void push_back(const T &value) {
-            insert(size(), value);
+            emplace_at(size(), value);
+        }
+
+        void push_back(T &&value) {
+            emplace_at(size(), std::move(value));
+        }
+
+        /**
+         * constructs an element in place at the end.
+         * returns a reference to the new element.
+         */
+        template<class... Args>
+        T &emplace_back(Args &&... args) {
+            return *emplace_at(size(), std::forward<Args>(args)...);
         }
 
         /**
@@ -489,9 +470,91 @@ namespace sjtu {
          * throw container_is_empty if size() == 0
          */
         void pop_back() {
-            if (size() == 0) throw container_is_empty();
-            delete *finish;
+            if (empty()) throw container_is_empty();
             --finish;
+            destroy(finish);
+        }
+
+    private:
+        /**
+         * leave n uninitialized slots at index ind, moving [ind, size) to the right.
+         * reallocates at most once; the gap is counted in size() on return.
+         */
+        pointer open_gap(const size_t &ind, const size_t &n) {
+            if (size() + n > capacity()) {
+                size_t cap = grown_capacity(size() + n);
+                pointer tmp = allocate(cap);
+                relocate(start, start + ind, tmp);
+                pointer cur = relocate(start + ind, finish, tmp + ind + n);
+                release();
+                start = tmp;
+                finish = cur;
+                end_of_storage = tmp + cap;
+            } else {
+                shift_right(start + ind, finish, n);
+                finish += n;
+            }
+            return start + ind;
+        }
+
+        /**
+         * undo open_gap after only the first built slots of the gap were constructed.
+         */
+        void close_gap(const size_t &ind, const size_t &n, const size_t &built) {
+            pointer gap = start + ind;
+            destroy(gap, gap + built);
+            finish = relocate(gap + n, finish, gap);
+        }
+
+        template<class InputIt>
+        iterator insert_range(const size_t &ind, InputIt first, InputIt last) {
+            size_t n = distance(first, last);
+            if (n == 0) return iterator(this, start + ind);
+            pointer gap = open_gap(ind, n);
+            size_t built = 0;
+            try {
+                for (; built < n; ++built, ++first) construct(gap + built, *first);
+            } catch (...) {
+                close_gap(ind, n, built);
+                throw;
+            }
+            return iterator(this, gap);
+        }
+
+        /**
+         * construct an element from args at index ind, shifting [ind, size) one slot to the right.
+         * args may refer to an element of this vector, so the new element is built
+         *   before anything it could alias is moved or released.
+         */
+        template<class... Args>
+        iterator emplace_at(const size_t &ind, Args &&... args) {
+            if (finish == end_of_storage) {
+                size_t cap = next_capacity();
+                pointer tmp = allocate(cap);
+                try {
+                    construct(tmp + ind, std::forward<Args>(args)...);
+                } catch (...) {
+                    deallocate(tmp, cap);
+                    throw;
+                }
+                relocate(start, start + ind, tmp);
+                pointer cur = relocate(start + ind, finish, tmp + ind + 1);
+                release();
+                start = tmp;
+                finish = cur;
+                end_of_storage = tmp + cap;
+                return iterator(this, start + ind);
+            }
+            pointer pos = start + ind;
+            if (pos == finish) {
+                construct(finish, std::forward<Args>(args)...);
+            } else {
+                value_type tmp(std::forward<Args>(args)...);
+                shift_right(pos, finish, 1);
+                construct(pos, std::move(tmp));
+            }
+            ++finish;
+            return iterator(this, pos);
         }
     };
 